@@ -0,0 +1,147 @@
+#include "aho_corasick.h"
+#include <queue>
+
+using namespace std;
+
+namespace dna
+{
+
+    int32_t AhoCorasick::add_state()
+    {
+        m_transitions.insert(m_transitions.end(), 4, -1);
+        m_output.push_back(-1);
+        m_output_link.push_back(-1);
+        return static_cast<int32_t>(m_output.size() - 1);
+    }
+
+    void AhoCorasick::build(const vector<string> &patterns)
+    {
+        m_transitions.clear();
+        m_output.clear();
+        m_output_link.clear();
+        m_duplicate_of.assign(patterns.size(), -1);
+        m_lengths.assign(patterns.size(), 0);
+
+        add_state();
+
+        // Trie of all patterns
+        for (size_t p = 0; p < patterns.size(); ++p)
+        {
+            const string &pattern = patterns[p];
+            m_lengths[p] = pattern.length();
+            m_duplicate_of[p] = static_cast<int32_t>(p);
+
+            if (pattern.empty())
+            {
+                continue;
+            }
+
+            int32_t state = 0;
+            for (char base : pattern)
+            {
+                int code = PackedSequence::encode(base);
+                if (m_transitions[state * 4 + code] < 0)
+                {
+                    int32_t next = add_state();
+                    m_transitions[state * 4 + code] = next;
+                }
+                state = m_transitions[state * 4 + code];
+            }
+
+            if (m_output[state] < 0)
+            {
+                m_output[state] = static_cast<int32_t>(p);
+            }
+            else
+            {
+                m_duplicate_of[p] = m_output[state];
+            }
+        }
+
+        // Breadth-first pass computing failure links, folded directly into the
+        // transition table so a missing edge points where the failure chain would go
+        vector<int32_t> failure(m_output.size(), 0);
+        queue<int32_t> states;
+
+        for (int code = 0; code < 4; ++code)
+        {
+            int32_t child = m_transitions[code];
+            if (child < 0)
+            {
+                m_transitions[code] = 0;
+            }
+            else
+            {
+                failure[child] = 0;
+                states.push(child);
+            }
+        }
+
+        while (!states.empty())
+        {
+            int32_t state = states.front();
+            states.pop();
+
+            int32_t fail = failure[state];
+            m_output_link[state] = m_output[fail] >= 0 ? fail : m_output_link[fail];
+
+            for (int code = 0; code < 4; ++code)
+            {
+                int32_t child = m_transitions[state * 4 + code];
+                if (child < 0)
+                {
+                    m_transitions[state * 4 + code] = m_transitions[fail * 4 + code];
+                }
+                else
+                {
+                    failure[child] = m_transitions[fail * 4 + code];
+                    states.push(child);
+                }
+            }
+        }
+    }
+
+    void AhoCorasick::search(const PackedSequence &text, vector<MatchList> &matches, uint64_t &transitions) const
+    {
+        transitions = 0;
+
+        if (m_output.empty())
+        {
+            return;
+        }
+
+        PackedSequence::Cursor reader = text.cursor();
+        int32_t state = 0;
+        size_t n = text.size();
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            int code = PackedSequence::encode(reader.next());
+            if (code < 0)
+            {
+                state = 0;
+                continue;
+            }
+
+            state = m_transitions[state * 4 + code];
+            transitions++;
+
+            // Report every pattern ending here: the state itself and its output chain
+            for (int32_t s = m_output[state] >= 0 ? state : m_output_link[state]; s >= 0; s = m_output_link[s])
+            {
+                int32_t pattern = m_output[s];
+                matches[pattern].push_back(i + 1 - m_lengths[pattern]);
+            }
+        }
+
+        // Identical patterns share one trie node; give each copy the same hits
+        for (size_t p = 0; p < m_duplicate_of.size(); ++p)
+        {
+            if (m_duplicate_of[p] != static_cast<int32_t>(p))
+            {
+                matches[p] = matches[m_duplicate_of[p]];
+            }
+        }
+    }
+
+} // namespace dna
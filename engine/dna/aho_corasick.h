@@ -0,0 +1,44 @@
+#ifndef AHO_CORASICK_H
+#define AHO_CORASICK_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "packed_sequence.h"
+#include "match_list.h"
+
+namespace dna
+{
+
+    // Aho-Corasick automaton over the A/C/G/T alphabet. Goto and failure
+    // transitions are folded into one dense table of 4 entries per state, so
+    // the scan does a single array lookup per base regardless of panel size.
+    class AhoCorasick
+    {
+    public:
+        AhoCorasick() = default;
+        ~AhoCorasick() = default;
+
+        // Build the automaton; patterns must only contain A/C/G/T (upper-case)
+        void build(const std::vector<std::string> &patterns);
+
+        // Scan the text once and add the start positions of every pattern to
+        // matches[pattern], which the caller sets up (one list per pattern).
+        // Non-ACGT bases reset the automaton. transitions counts table lookups.
+        void search(const PackedSequence &text, std::vector<MatchList> &matches, uint64_t &transitions) const;
+
+        size_t state_count() const { return m_output.size(); }
+
+    private:
+        std::vector<int32_t> m_transitions;  // 4 entries per state
+        std::vector<int32_t> m_output;       // Pattern ending at this state, or -1
+        std::vector<int32_t> m_output_link;  // Nearest suffix state with an output, or -1
+        std::vector<int32_t> m_duplicate_of; // Per pattern: first identical pattern
+        std::vector<size_t> m_lengths;       // Per pattern: length
+
+        int32_t add_state();
+    };
+
+} // namespace dna
+
+#endif // AHO_CORASICK_H
@@ -0,0 +1,200 @@
+#include "approximate_search.h"
+#include <algorithm>
+#include <cstdint>
+
+using namespace std;
+
+namespace dna
+{
+    namespace approximate
+    {
+
+        namespace
+        {
+            // Bit i of masks[c] is set when pattern[i] == c
+            void build_masks(const string &pattern, uint64_t masks[256])
+            {
+                fill(masks, masks + 256, 0);
+                for (size_t i = 0; i < pattern.length(); ++i)
+                {
+                    masks[static_cast<unsigned char>(pattern[i])] |= uint64_t(1) << i;
+                }
+            }
+
+            // Length of the text span, ending at end, that aligns best with the pattern
+            size_t alignment_span(const PackedSequence &text, const string &pattern, size_t end, int max_errors)
+            {
+                size_t m = pattern.length();
+                size_t window = min(end + 1, m + static_cast<size_t>(max_errors));
+
+                string reversed_text(window, 'A');
+                text.decode(end + 1 - window, window, &reversed_text[0]);
+                reverse(reversed_text.begin(), reversed_text.end());
+
+                // Edit distance DP on the reversed strings: both anchored at the
+                // end position, free to stop anywhere in the text window
+                vector<int> previous(window + 1), current(window + 1);
+                for (size_t l = 0; l <= window; ++l)
+                {
+                    previous[l] = static_cast<int>(l);
+                }
+
+                for (size_t i = 1; i <= m; ++i)
+                {
+                    current[0] = static_cast<int>(i);
+                    char p = pattern[m - i];
+                    for (size_t l = 1; l <= window; ++l)
+                    {
+                        int substitution = previous[l - 1] + (p != reversed_text[l - 1]);
+                        current[l] = min({substitution, previous[l] + 1, current[l - 1] + 1});
+                    }
+                    previous.swap(current);
+                }
+
+                // Best distance, ties broken towards the span closest to the pattern length
+                auto gap = [m](size_t l)
+                { return l > m ? l - m : m - l; };
+
+                size_t best = 0;
+                for (size_t l = 1; l <= window; ++l)
+                {
+                    if (previous[l] < previous[best] || (previous[l] == previous[best] && gap(l) < gap(best)))
+                    {
+                        best = l;
+                    }
+                }
+                return best;
+            }
+        }
+
+        vector<ApproximateMatch> hamming_search(const PackedSequence &text, const string &pattern,
+                                                int max_errors, uint64_t &operations)
+        {
+            vector<ApproximateMatch> matches;
+            size_t n = text.size();
+            size_t m = pattern.length();
+            operations = 0;
+
+            if (m == 0 || m > MAX_PATTERN_LENGTH || n < m || max_errors < 0)
+            {
+                return matches;
+            }
+
+            int k = min(max_errors, static_cast<int>(m));
+            uint64_t masks[256];
+            build_masks(pattern, masks);
+
+            // state[d] bit i: pattern[0..i] matches the text ending here with at most d mismatches
+            vector<uint64_t> state(k + 1, 0);
+            const uint64_t accept = uint64_t(1) << (m - 1);
+            PackedSequence::Cursor reader = text.cursor();
+
+            for (size_t j = 0; j < n; ++j)
+            {
+                uint64_t mask = masks[static_cast<unsigned char>(reader.next())];
+
+                uint64_t previous_level = state[0];
+                state[0] = ((state[0] << 1) | 1) & mask;
+                for (int d = 1; d <= k; ++d)
+                {
+                    uint64_t old_level = state[d];
+                    // Extend a match at this level, or spend one mismatch from the level below
+                    state[d] = (((old_level << 1) | 1) & mask) | ((previous_level << 1) | 1);
+                    previous_level = old_level;
+                }
+                operations += k + 1;
+
+                if (j + 1 >= m && (state[k] & accept))
+                {
+                    int distance = 0;
+                    while (!(state[distance] & accept))
+                    {
+                        distance++;
+                    }
+                    matches.push_back({j + 1 - m, distance, m});
+                }
+            }
+
+            return matches;
+        }
+
+        vector<ApproximateMatch> edit_search(const PackedSequence &text, const string &pattern,
+                                             int max_errors, uint64_t &operations)
+        {
+            vector<ApproximateMatch> matches;
+            size_t n = text.size();
+            size_t m = pattern.length();
+            operations = 0;
+
+            if (m == 0 || m > MAX_PATTERN_LENGTH || max_errors < 0)
+            {
+                return matches;
+            }
+
+            uint64_t masks[256];
+            build_masks(pattern, masks);
+
+            // Vertical deltas of the DP column, encoded as positive/negative bit vectors
+            uint64_t positive = ~uint64_t(0);
+            uint64_t negative = 0;
+            int score = static_cast<int>(m);
+            const uint64_t high_bit = uint64_t(1) << (m - 1);
+
+            // Best end position of the current run of hits
+            bool in_run = false;
+            size_t best_end = 0;
+            int best_score = 0;
+
+            PackedSequence::Cursor reader = text.cursor();
+            for (size_t j = 0; j <= n; ++j)
+            {
+                bool hit = false;
+                if (j < n)
+                {
+                    uint64_t eq = masks[static_cast<unsigned char>(reader.next())];
+                    uint64_t xv = eq | negative;
+                    uint64_t xh = (((eq & positive) + positive) ^ positive) | eq;
+                    uint64_t horizontal_positive = negative | ~(xh | positive);
+                    uint64_t horizontal_negative = positive & xh;
+
+                    if (horizontal_positive & high_bit)
+                    {
+                        score++;
+                    }
+                    else if (horizontal_negative & high_bit)
+                    {
+                        score--;
+                    }
+
+                    // The top row is all zeros in search mode, so nothing is shifted in
+                    horizontal_positive <<= 1;
+                    horizontal_negative <<= 1;
+                    positive = horizontal_negative | ~(xv | horizontal_positive);
+                    negative = horizontal_positive & xv;
+                    operations++;
+
+                    hit = score <= max_errors;
+                }
+
+                if (hit)
+                {
+                    if (!in_run || score < best_score)
+                    {
+                        best_end = j;
+                        best_score = score;
+                    }
+                    in_run = true;
+                }
+                else if (in_run)
+                {
+                    size_t span = alignment_span(text, pattern, best_end, max_errors);
+                    matches.push_back({best_end + 1 - span, best_score, span});
+                    in_run = false;
+                }
+            }
+
+            return matches;
+        }
+
+    } // namespace approximate
+} // namespace dna
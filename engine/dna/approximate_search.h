@@ -0,0 +1,41 @@
+#ifndef APPROXIMATE_SEARCH_H
+#define APPROXIMATE_SEARCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "packed_sequence.h"
+
+namespace dna
+{
+
+    // One approximate occurrence: where the aligned text starts, how many
+    // errors it has and how many text bases the alignment spans
+    struct ApproximateMatch
+    {
+        size_t position;
+        int distance;
+        size_t length;
+    };
+
+    // Bit-parallel k-error search. Every pattern position is one bit of a
+    // 64-bit word, so patterns are limited to MAX_PATTERN_LENGTH bases and each
+    // text base costs O(k) (Hamming) or O(1) (edit distance) word operations.
+    namespace approximate
+    {
+        const size_t MAX_PATTERN_LENGTH = 64;
+
+        // Shift-And with k mismatch levels (Wu-Manber): substitutions only
+        std::vector<ApproximateMatch> hamming_search(const PackedSequence &text, const std::string &pattern,
+                                                     int max_errors, uint64_t &operations);
+
+        // Myers' bit-vector algorithm: substitutions, insertions and deletions.
+        // Each run of adjacent end positions is reported once, at its best score.
+        std::vector<ApproximateMatch> edit_search(const PackedSequence &text, const std::string &pattern,
+                                                  int max_errors, uint64_t &operations);
+    }
+
+} // namespace dna
+
+#endif // APPROXIMATE_SEARCH_H
@@ -1,102 +1,747 @@
 #include "dna_search.h"
 #include <algorithm>
 #include <cctype>
+#include <cstring>
+#include <sstream>
+#include "../utils/mapped_file.h"
+#include "../utils/thread_pool.h"
+#include "../utils/block_reader.h"
 
 using namespace std;
 namespace dna
 {
 
+    namespace
+    {
+        // Records with a blank header are named after their position
+        string default_contig_name(const string &name, size_t index)
+        {
+            return name.empty() ? "contig_" + to_string(index + 1) : name;
+        }
+    }
+
     bool DNASearchEngine::load_fasta(const string &filename)
     {
-        ifstream file(filename);
-        if (!file.is_open())
+        utils::MappedFile file;
+        if (!file.open(filename))
         {
             cerr << "Error: Could not open file " << filename << endl;
             return false;
         }
 
-        string line;
         m_dna_sequence.clear();
+        m_contigs.clear();
+        m_contig_ends.reset();
+        m_index = FMIndex();
+
+        const char *data = file.data();
+        const char *end = data + file.size();
+
+        // Skip leading blank lines; the first record must start with a header
+        while (data < end && isspace(static_cast<unsigned char>(*data)))
+        {
+            data++;
+        }
 
-        // Skip header line (starts with '>')
-        if (getline(file, line) && line[0] != '>')
+        if (data == end || *data != '>')
         {
             cerr << "Error: Invalid FASTA format. Header line should start with '>'" << endl;
             return false;
         }
 
-        while (getline(file, line))
-        {
+        // The file length is an upper bound on the number of bases
+        m_dna_sequence.reserve(file.size());
 
-            if (line.empty() || line[0] == '>')
+        while (data < end)
+        {
+            // Header line: the record name is the first word after '>'
+            const char *line_end = static_cast<const char *>(memchr(data, '\n', end - data));
+            if (line_end == nullptr)
             {
-                continue;
+                line_end = end;
             }
 
-            // Remove whitespace and convert to uppercase
-            line.erase(remove_if(line.begin(), line.end(), ::isspace), line.end());
-            transform(line.begin(), line.end(), line.begin(), ::toupper);
-
-            // Validate DNA characters (A, C, G, T)
-            for (char c : line)
+            const char *name = data + 1;
+            while (name < line_end && isspace(static_cast<unsigned char>(*name)))
             {
-                if (c != 'A' && c != 'C' && c != 'G' && c != 'T')
+                name++;
+            }
+            const char *name_end = name;
+            while (name_end < line_end && !isspace(static_cast<unsigned char>(*name_end)))
+            {
+                name_end++;
+            }
+            m_contigs.emplace_back(default_contig_name(string(name, name_end), m_contigs.size()),
+                                   m_dna_sequence.size());
+
+            // Sequence block: everything up to the next line starting with '>'.
+            // The whole block is packed in one pass, append() drops the line breaks.
+            const char *block = line_end;
+            const char *block_end = block;
+            while (block_end < end)
+            {
+                const char *next_header = static_cast<const char *>(memchr(block_end, '>', end - block_end));
+                if (next_header == nullptr)
+                {
+                    block_end = end;
+                    break;
+                }
+
+                block_end = next_header;
+                if (next_header[-1] == '\n')
                 {
-                    cerr << "Warning: Non-standard DNA character '" << c << "' found in sequence" << endl;
+                    break;
                 }
+                block_end++;
             }
 
-            m_dna_sequence += line;
+            m_contigs.back().length = m_dna_sequence.append(block, block_end - block);
+            data = block_end;
         }
 
-        file.close();
-
         if (m_dna_sequence.empty())
         {
             cerr << "Error: No DNA sequence found in file" << endl;
+            m_contigs.clear();
             return false;
         }
 
+        if (m_contigs.size() > 1)
+        {
+            auto ends = make_shared<vector<uint64_t>>();
+            for (const Contig &contig : m_contigs)
+            {
+                ends->push_back(contig.offset + contig.length);
+            }
+            m_contig_ends = ends;
+        }
+
         cout << "Successfully loaded DNA sequence of length " << m_dna_sequence.size() << endl;
+        cout << "  - Records: " << m_contigs.size() << endl;
+        cout << "  - Packed storage: " << m_dna_sequence.memory_usage() << " bytes" << endl;
+        if (m_dna_sequence.exception_runs() > 0)
+        {
+            cerr << "Warning: " << m_dna_sequence.exception_runs()
+                 << " run(s) of non-standard DNA characters found in sequence" << endl;
+        }
         return true;
     }
 
+    size_t DNASearchEngine::find_contig(size_t position) const
+    {
+        auto it = upper_bound(m_contigs.begin(), m_contigs.end(), position,
+                              [](size_t pos, const Contig &contig)
+                              { return pos < contig.offset; });
+        return it == m_contigs.begin() ? 0 : (it - m_contigs.begin()) - 1;
+    }
+
+    MatchList DNASearchEngine::new_match_list(size_t pattern_length, bool count_only) const
+    {
+        MatchList matches(count_only);
+        if (m_contig_ends)
+        {
+            matches.set_boundaries(m_contig_ends, pattern_length);
+        }
+        return matches;
+    }
+
     void DNASearchEngine::search_pattern(const string &pattern, const string &algorithm)
     {
         m_pattern = pattern;
         m_algorithm = algorithm;
         m_comparisons = 0;
+        m_pattern_hits.clear();
+        m_approximate_matches.clear();
+        m_strands.clear();
 
         // Convert pattern to uppercase
         string pattern_upper = pattern;
         transform(pattern_upper.begin(), pattern_upper.end(), pattern_upper.begin(), ::toupper);
 
+        if (algorithm != "KMP" && algorithm != "parallel-KMP" && algorithm != "naive" && algorithm != "SIMD" &&
+            algorithm != "FM-index")
+        {
+            cerr << "Unknown algorithm: " << algorithm << ". Using KMP by default." << endl;
+            m_algorithm = "KMP";
+        }
+
+        if (m_algorithm == "FM-index")
+        {
+            if (!FMIndex::is_searchable(pattern_upper))
+            {
+                cerr << "Warning: FM-index only supports A/C/G/T patterns. Using KMP instead." << endl;
+                m_algorithm = "KMP";
+            }
+            else if (m_index.empty() && !build_index())
+            {
+                m_algorithm = "KMP";
+            }
+        }
+
         auto start_time = chrono::high_resolution_clock::now();
 
-        if (algorithm == "KMP")
+        m_matches = new_match_list(pattern_upper.length(), m_count_only);
+        run_algorithm(m_algorithm, pattern_upper, m_matches, m_comparisons);
+
+        auto end_time = chrono::high_resolution_clock::now();
+        m_execution_time_ms = chrono::duration<double, milli>(end_time - start_time).count();
+
+        cout << "Pattern search complete using " << m_algorithm << " algorithm";
+        if (m_algorithm == "SIMD")
         {
-            m_matches = kmp_search(m_dna_sequence, pattern_upper, m_comparisons);
+            cout << " (" << simd::backend_name() << ")";
         }
-        else if (algorithm == "naive")
+        cout << ":" << endl;
+        cout << "  - Found " << m_matches.size() << " matches" << endl;
+        cout << "  - Performed " << m_comparisons << " comparisons" << endl;
+        cout << "  - Execution time: " << m_execution_time_ms << " ms" << endl;
+    }
+
+    void DNASearchEngine::search_approximate(const string &pattern, int max_errors, const string &mode)
+    {
+        m_pattern = pattern;
+        m_algorithm = mode == "edit" ? "Myers" : "Shift-And";
+        m_max_errors = max_errors;
+        m_comparisons = 0;
+        m_matches = MatchList();
+        m_pattern_hits.clear();
+        m_approximate_matches.clear();
+        m_strands.clear();
+
+        if (mode != "hamming" && mode != "edit")
         {
-            m_matches = naive_search(m_dna_sequence, pattern_upper, m_comparisons);
+            cerr << "Unknown approximate search mode: " << mode << ". Using hamming by default." << endl;
         }
-        else
+
+        if (pattern.empty() || pattern.length() > approximate::MAX_PATTERN_LENGTH)
         {
-            cerr << "Unknown algorithm: " << algorithm << ". Using KMP by default." << endl;
-            m_algorithm = "KMP";
-            m_matches = kmp_search(m_dna_sequence, pattern_upper, m_comparisons);
+            cerr << "Error: Approximate search supports patterns of 1 to " << approximate::MAX_PATTERN_LENGTH
+                 << " bases" << endl;
+            return;
+        }
+
+        string pattern_upper = pattern;
+        transform(pattern_upper.begin(), pattern_upper.end(), pattern_upper.begin(), ::toupper);
+
+        auto start_time = chrono::high_resolution_clock::now();
+
+        vector<ApproximateMatch> matches = mode == "edit"
+                                               ? approximate::edit_search(m_dna_sequence, pattern_upper, max_errors, m_comparisons)
+                                               : approximate::hamming_search(m_dna_sequence, pattern_upper, max_errors, m_comparisons);
+
+        // Alignments are reported by end position; the match list needs them by start
+        stable_sort(matches.begin(), matches.end(), [](const ApproximateMatch &a, const ApproximateMatch &b)
+                    { return a.position < b.position; });
+
+        // Keep only alignments that lie within a single contig
+        for (const ApproximateMatch &match : matches)
+        {
+            const Contig &contig = m_contigs[find_contig(match.position)];
+            if (match.position + match.length <= contig.offset + contig.length)
+            {
+                m_approximate_matches.push_back(match);
+                m_matches.push_back(match.position);
+            }
         }
 
         auto end_time = chrono::high_resolution_clock::now();
         m_execution_time_ms = chrono::duration<double, milli>(end_time - start_time).count();
 
-        cout << "Pattern search complete using " << m_algorithm << " algorithm:" << endl;
+        cout << "Approximate search complete using " << m_algorithm << " algorithm (k = " << max_errors << "):" << endl;
         cout << "  - Found " << m_matches.size() << " matches" << endl;
-        cout << "  - Performed " << m_comparisons << " comparisons" << endl;
+        cout << "  - Performed " << m_comparisons << " bit-vector steps" << endl;
+        cout << "  - Execution time: " << m_execution_time_ms << " ms" << endl;
+    }
+
+    void DNASearchEngine::search_degenerate(const string &pattern, bool both_strands)
+    {
+        m_pattern = pattern;
+        m_algorithm = "IUPAC";
+        m_comparisons = 0;
+        m_matches = MatchList();
+        m_pattern_hits.clear();
+        m_approximate_matches.clear();
+        m_strands.clear();
+
+        string pattern_upper = pattern;
+        transform(pattern_upper.begin(), pattern_upper.end(), pattern_upper.begin(), ::toupper);
+
+        if (pattern_upper.empty() || pattern_upper.length() > iupac::MAX_PATTERN_LENGTH ||
+            !iupac::is_valid_pattern(pattern_upper))
+        {
+            cerr << "Error: Degenerate search needs 1 to " << iupac::MAX_PATTERN_LENGTH
+                 << " IUPAC nucleotide codes" << endl;
+            return;
+        }
+
+        auto start_time = chrono::high_resolution_clock::now();
+
+        vector<StrandMatch> matches = iupac::search(m_dna_sequence, pattern_upper, both_strands, m_comparisons);
+
+        // Keep only hits that lie within a single contig
+        m_matches = new_match_list(pattern_upper.length(), false);
+        for (const StrandMatch &match : matches)
+        {
+            if (m_matches.push_back(match.position))
+            {
+                m_strands.push_back(match.strand);
+            }
+        }
+
+        auto end_time = chrono::high_resolution_clock::now();
+        m_execution_time_ms = chrono::duration<double, milli>(end_time - start_time).count();
+
+        size_t reverse_hits = count(m_strands.begin(), m_strands.end(), '-');
+        cout << "Degenerate search complete using " << m_algorithm << " masks"
+             << (both_strands ? " on both strands" : "") << ":" << endl;
+        cout << "  - Found " << m_matches.size() << " matches (" << m_matches.size() - reverse_hits
+             << " forward, " << reverse_hits << " reverse)" << endl;
         cout << "  - Execution time: " << m_execution_time_ms << " ms" << endl;
     }
 
+    bool DNASearchEngine::stream_search(const string &fasta_filename, const string &pattern,
+                                        const string &output_filename)
+    {
+        string pattern_upper = pattern;
+        transform(pattern_upper.begin(), pattern_upper.end(), pattern_upper.begin(), ::toupper);
+
+        if (pattern_upper.empty())
+        {
+            cerr << "Error: Empty search pattern" << endl;
+            return false;
+        }
+
+        utils::BlockReader reader;
+        if (!reader.open(fasta_filename))
+        {
+            cerr << "Error: Could not open file " << fasta_filename << endl;
+            return false;
+        }
+
+        utils::JSONStreamWriter writer;
+        if (!writer.open(output_filename))
+        {
+            return false;
+        }
+
+        m_pattern = pattern;
+        m_algorithm = "streaming-KMP";
+        m_matches = MatchList();
+        m_pattern_hits.clear();
+        m_approximate_matches.clear();
+        m_strands.clear();
+
+        writer.add_string("pattern", m_pattern);
+        writer.add_string("algorithm", m_algorithm);
+        writer.start_array("matches");
+
+        auto start_time = chrono::high_resolution_clock::now();
+
+        const vector<int> pi = compute_prefix_function(pattern_upper);
+        const uint64_t m = pattern_upper.length();
+
+        // Parser and matcher state, both carried across block boundaries
+        bool at_line_start = true;
+        bool in_header = false;
+        bool reading_name = false;
+        vector<Contig> contigs;
+        uint64_t position = 0;
+        uint64_t match_count = 0;
+        uint64_t comparisons = 0;
+        uint64_t k = 0;
+
+        const char *block;
+        size_t block_size;
+        while (reader.next(block, block_size))
+        {
+            for (size_t i = 0; i < block_size; ++i)
+            {
+                char c = block[i];
+
+                if (in_header)
+                {
+                    if (c == '\n')
+                    {
+                        in_header = false;
+                        at_line_start = true;
+                    }
+                    else if (isspace(static_cast<unsigned char>(c)))
+                    {
+                        // Spaces before the name do not end it
+                        reading_name = contigs.back().name.empty();
+                    }
+                    else if (reading_name)
+                    {
+                        contigs.back().name += c;
+                    }
+                    continue;
+                }
+
+                if (at_line_start && c == '>')
+                {
+                    // New record: matches never span two records
+                    if (!contigs.empty())
+                    {
+                        contigs.back().length = position - contigs.back().offset;
+                    }
+                    contigs.emplace_back("", position);
+                    in_header = true;
+                    reading_name = true;
+                    k = 0;
+                    continue;
+                }
+
+                at_line_start = c == '\n';
+                if (isspace(static_cast<unsigned char>(c)))
+                {
+                    continue;
+                }
+
+                if (contigs.empty())
+                {
+                    cerr << "Error: Invalid FASTA format. Header line should start with '>'" << endl;
+                    writer.end_array();
+                    writer.close();
+                    return false;
+                }
+
+                char base = static_cast<char>(toupper(static_cast<unsigned char>(c)));
+
+                while (k > 0 && pattern_upper[k] != base)
+                {
+                    k = pi[k - 1];
+                    comparisons++;
+                }
+
+                if (pattern_upper[k] == base)
+                {
+                    k++;
+                }
+                comparisons++;
+
+                if (k == m)
+                {
+                    writer.add_array_value(position - m + 1);
+                    match_count++;
+                    k = pi[k - 1];
+                }
+
+                position++;
+            }
+        }
+        writer.end_array();
+
+        if (!contigs.empty())
+        {
+            contigs.back().length = position - contigs.back().offset;
+        }
+
+        auto end_time = chrono::high_resolution_clock::now();
+        m_execution_time_ms = chrono::duration<double, milli>(end_time - start_time).count();
+        m_comparisons = comparisons;
+
+        writer.add_int("dna_length", position);
+        writer.add_int("match_count", match_count);
+        writer.add_int("comparisons", comparisons);
+        writer.add_double("execution_time_ms", m_execution_time_ms);
+        writer.start_array("contigs");
+        for (size_t i = 0; i < contigs.size(); ++i)
+        {
+            const Contig &contig = contigs[i];
+            writer.add_array_object({{"name", default_contig_name(contig.name, i)},
+                                     {"offset", to_string(contig.offset)},
+                                     {"length", to_string(contig.length)}});
+        }
+        writer.end_array();
+
+        cout << "Streaming search complete using " << m_algorithm << " algorithm:" << endl;
+        cout << "  - Scanned " << position << " bases in " << contigs.size() << " records" << endl;
+        cout << "  - Found " << match_count << " matches" << endl;
+        cout << "  - Execution time: " << m_execution_time_ms << " ms" << endl;
+
+        return writer.close();
+    }
+
+    void DNASearchEngine::search_patterns(const vector<string> &patterns, const vector<string> &names)
+    {
+        m_pattern = "";
+        m_algorithm = "Aho-Corasick";
+        m_comparisons = 0;
+        m_matches = MatchList();
+        m_pattern_hits.clear();
+        m_approximate_matches.clear();
+        m_strands.clear();
+
+        // Only A/C/G/T probes can go into the automaton
+        vector<string> panel;
+        for (size_t i = 0; i < patterns.size(); ++i)
+        {
+            string pattern_upper = patterns[i];
+            transform(pattern_upper.begin(), pattern_upper.end(), pattern_upper.begin(), ::toupper);
+
+            if (pattern_upper.empty() || !FMIndex::is_searchable(pattern_upper))
+            {
+                cerr << "Warning: Skipping pattern '" << patterns[i] << "' (only A/C/G/T patterns are supported)" << endl;
+                continue;
+            }
+
+            PatternHits hits;
+            hits.name = i < names.size() ? names[i] : patterns[i];
+            hits.pattern = pattern_upper;
+            hits.matches = new_match_list(pattern_upper.length(), m_count_only);
+            m_pattern_hits.push_back(hits);
+            panel.push_back(pattern_upper);
+        }
+
+        auto start_time = chrono::high_resolution_clock::now();
+
+        AhoCorasick automaton;
+        automaton.build(panel);
+
+        vector<MatchList> matches;
+        for (const PatternHits &hits : m_pattern_hits)
+        {
+            matches.push_back(hits.matches);
+        }
+        automaton.search(m_dna_sequence, matches, m_comparisons);
+
+        uint64_t total_matches = 0;
+        for (size_t i = 0; i < m_pattern_hits.size(); ++i)
+        {
+            m_pattern_hits[i].matches = move(matches[i]);
+            total_matches += m_pattern_hits[i].matches.size();
+        }
+
+        auto end_time = chrono::high_resolution_clock::now();
+        m_execution_time_ms = chrono::duration<double, milli>(end_time - start_time).count();
+
+        cout << "Multi-pattern search complete using " << m_algorithm << " algorithm:" << endl;
+        cout << "  - Patterns: " << m_pattern_hits.size() << " (" << automaton.state_count() << " automaton states)" << endl;
+        cout << "  - Found " << total_matches << " matches" << endl;
+        cout << "  - Execution time: " << m_execution_time_ms << " ms" << endl;
+    }
+
+    bool DNASearchEngine::search_pattern_file(const string &filename)
+    {
+        ifstream file(filename);
+        if (!file.is_open())
+        {
+            cerr << "Error: Could not open file " << filename << endl;
+            return false;
+        }
+
+        // Either a FASTA of probes (the header names each record) or a plain list, one pattern per line
+        vector<string> patterns, names;
+        bool is_fasta = false;
+        string line;
+        while (getline(file, line))
+        {
+            if (!line.empty() && line[0] == '>')
+            {
+                is_fasta = true;
+                stringstream header(line.substr(1));
+                string name;
+                header >> name;
+                names.push_back(name);
+                patterns.emplace_back();
+                continue;
+            }
+
+            line.erase(remove_if(line.begin(), line.end(), ::isspace), line.end());
+            if (line.empty())
+            {
+                continue;
+            }
+
+            if (is_fasta)
+            {
+                patterns.back() += line;
+            }
+            else
+            {
+                names.push_back(line);
+                patterns.push_back(line);
+            }
+        }
+
+        if (patterns.empty())
+        {
+            cerr << "Error: No patterns found in file " << filename << endl;
+            return false;
+        }
+
+        search_patterns(patterns, names);
+        return true;
+    }
+
+    void DNASearchEngine::run_algorithm(const string &algorithm, const string &pattern, MatchList &matches,
+                                        uint64_t &comparisons)
+    {
+        if (algorithm == "naive")
+        {
+            naive_search(m_dna_sequence, pattern, matches, comparisons);
+        }
+        else if (algorithm == "FM-index")
+        {
+            index_search(pattern, matches, comparisons);
+        }
+        else if (algorithm == "SIMD")
+        {
+            simd_search(m_dna_sequence, pattern, matches, comparisons);
+        }
+        else if (algorithm == "parallel-KMP")
+        {
+            parallel_kmp_search(m_dna_sequence, pattern, matches, comparisons);
+        }
+        else
+        {
+            kmp_search(m_dna_sequence, pattern, matches, comparisons);
+        }
+    }
+
+    bool DNASearchEngine::build_index()
+    {
+        if (m_dna_sequence.empty())
+        {
+            cerr << "Error: Load a DNA sequence before building the index" << endl;
+            return false;
+        }
+
+        auto start_time = chrono::high_resolution_clock::now();
+        if (!m_index.build(m_dna_sequence))
+        {
+            return false;
+        }
+        auto end_time = chrono::high_resolution_clock::now();
+
+        cout << "Built FM-index over " << m_dna_sequence.size() << " bases in "
+             << chrono::duration<double, milli>(end_time - start_time).count() << " ms" << endl;
+        return true;
+    }
+
+    bool DNASearchEngine::save_index(const string &filename) const
+    {
+        if (m_index.empty())
+        {
+            cerr << "Error: No FM-index has been built" << endl;
+            return false;
+        }
+        return m_index.save(filename);
+    }
+
+    bool DNASearchEngine::load_index(const string &filename)
+    {
+        FMIndex index;
+        if (!index.load(filename))
+        {
+            return false;
+        }
+
+        if (index.text_length() != m_dna_sequence.size())
+        {
+            cerr << "Error: FM-index " << filename << " was built for a sequence of length "
+                 << index.text_length() << ", loaded sequence has length " << m_dna_sequence.size() << endl;
+            return false;
+        }
+
+        if (index.text_checksum() != m_dna_sequence.checksum())
+        {
+            cerr << "Error: FM-index " << filename << " was built for a different sequence of the same length" << endl;
+            return false;
+        }
+
+        m_index = move(index);
+        return true;
+    }
+
+    void DNASearchEngine::index_search(const string &pattern, MatchList &matches, uint64_t &comparisons)
+    {
+        comparisons = 0;
+
+        // Without contig boundaries to check, counting needs no suffix array lookups
+        if (matches.count_only() && !m_contig_ends)
+        {
+            matches.add_count(m_index.count(pattern, comparisons));
+            return;
+        }
+
+        for (size_t position : m_index.locate(pattern, comparisons))
+        {
+            matches.push_back(position);
+        }
+    }
+
+    bool DNASearchEngine::benchmark(const vector<string> &patterns, const string &filename)
+    {
+        if (m_dna_sequence.empty())
+        {
+            cerr << "Error: Load a DNA sequence before running the benchmark" << endl;
+            return false;
+        }
+
+        auto build_start = chrono::high_resolution_clock::now();
+        if (m_index.empty() && !build_index())
+        {
+            return false;
+        }
+        double build_time_ms = chrono::duration<double, milli>(chrono::high_resolution_clock::now() - build_start).count();
+
+        vector<string> patterns_upper;
+        for (const string &pattern : patterns)
+        {
+            string pattern_upper = pattern;
+            transform(pattern_upper.begin(), pattern_upper.end(), pattern_upper.begin(), ::toupper);
+            if (FMIndex::is_searchable(pattern_upper))
+            {
+                patterns_upper.push_back(pattern_upper);
+            }
+            else
+            {
+                cerr << "Warning: Skipping pattern '" << pattern << "' (only A/C/G/T patterns can be benchmarked)" << endl;
+            }
+        }
+
+        utils::JSONExporter exporter;
+        exporter.add_int("dna_length", m_dna_sequence.size());
+        exporter.add_int("pattern_count", patterns_upper.size());
+        exporter.add_double("index_build_time_ms", build_time_ms);
+
+        cout << "Benchmark over " << patterns_upper.size() << " patterns:" << endl;
+
+        const vector<string> algorithms = {"naive", "KMP", "parallel-KMP", "SIMD", "FM-index"};
+        exporter.start_array("algorithms");
+        for (size_t a = 0; a < algorithms.size(); ++a)
+        {
+            uint64_t total_comparisons = 0;
+            uint64_t total_matches = 0;
+
+            auto start_time = chrono::high_resolution_clock::now();
+            for (const string &pattern : patterns_upper)
+            {
+                // Only the totals are reported, so the positions are not kept
+                MatchList matches = new_match_list(pattern.length(), true);
+                uint64_t comparisons = 0;
+                run_algorithm(algorithms[a], pattern, matches, comparisons);
+                total_matches += matches.size();
+                total_comparisons += comparisons;
+            }
+            double time_ms = chrono::duration<double, milli>(chrono::high_resolution_clock::now() - start_time).count();
+
+            cout << "  - " << algorithms[a] << ": " << time_ms << " ms, "
+                 << total_comparisons << " comparisons, " << total_matches << " matches" << endl;
+
+            map<string, string> algorithm_obj = {
+                {"algorithm", algorithms[a]},
+                {"total_time_ms", to_string(time_ms)},
+                {"comparisons", to_string(total_comparisons)},
+                {"matches", to_string(total_matches)}};
+            exporter.add_object_to_array(algorithm_obj, a == algorithms.size() - 1);
+        }
+        exporter.end_array();
+
+        return exporter.export_to_file(filename);
+    }
+
     vector<int> DNASearchEngine::compute_prefix_function(const string &pattern)
     {
         int m = pattern.length();
@@ -120,35 +765,45 @@ namespace dna
         return pi;
     }
 
-    vector<int> DNASearchEngine::kmp_search(const string &text, const string &pattern, int &comparisons)
+    void DNASearchEngine::kmp_search(const PackedSequence &text, const string &pattern, MatchList &matches,
+                                     uint64_t &comparisons)
     {
-        vector<int> matches;
-        int n = text.length();
-        int m = pattern.length();
+        size_t n = text.size();
+        size_t m = pattern.length();
         comparisons = 0;
 
         if (m == 0)
         {
-            return matches;
+            return;
         }
 
         if (n < m)
         {
-            return matches;
+            return;
         }
 
         // Compute prefix function for pattern
         vector<int> pi = compute_prefix_function(pattern);
+        kmp_scan(text, pattern, pi, 0, n, matches, comparisons);
+    }
+
+    void DNASearchEngine::kmp_scan(const PackedSequence &text, const string &pattern, const vector<int> &pi,
+                                   size_t begin, size_t end, MatchList &matches, uint64_t &comparisons)
+    {
+        size_t m = pattern.length();
+        PackedSequence::Cursor reader = text.cursor(begin);
 
-        for (int i = 0, k = 0; i < n; ++i) 
+        for (size_t i = begin, k = 0; i < end; ++i)
         {
-            while (k > 0 && pattern[k] != text[i])
+            char base = reader.next();
+
+            while (k > 0 && pattern[k] != base)
             {
                 k = pi[k - 1];
                 comparisons++;
             }
 
-            if (pattern[k] == text[i])
+            if (pattern[k] == base)
             {
                 k++;
             }
@@ -161,35 +816,99 @@ namespace dna
                 k = pi[k - 1];
             }
         }
+    }
 
-        return matches;
+    void DNASearchEngine::parallel_kmp_search(const PackedSequence &text, const string &pattern, MatchList &matches,
+                                              uint64_t &comparisons)
+    {
+        size_t n = text.size();
+        size_t m = pattern.length();
+        comparisons = 0;
+
+        if (m == 0 || n < m)
+        {
+            return;
+        }
+
+        vector<int> pi = compute_prefix_function(pattern);
+
+        // One chunk per thread, but never so small that thread hand-off dominates
+        const size_t min_chunk_size = 1 << 20;
+        utils::ThreadPool &pool = utils::ThreadPool::shared();
+        size_t chunk_count = min<size_t>(pool.size(), max<size_t>(1, n / min_chunk_size));
+        size_t chunk_size = (n + chunk_count - 1) / chunk_count;
+
+        vector<MatchList> chunk_matches(chunk_count, matches.with_same_settings());
+        vector<uint64_t> chunk_comparisons(chunk_count, 0);
+
+        pool.parallel_for(chunk_count, [&](size_t chunk)
+                          {
+            // Chunks overlap by m - 1 bases. A match ending in the overlap starts
+            // inside this chunk, so each match is found by exactly one chunk.
+            size_t begin = chunk * chunk_size;
+            size_t owned_end = min(n, begin + chunk_size);
+            size_t end = min(n, owned_end + m - 1);
+            kmp_scan(text, pattern, pi, begin, end, chunk_matches[chunk], chunk_comparisons[chunk]); });
+
+        // Chunks are in text order, so concatenating keeps m_matches sorted
+        for (size_t chunk = 0; chunk < chunk_count; ++chunk)
+        {
+            matches.append(chunk_matches[chunk]);
+            comparisons += chunk_comparisons[chunk];
+        }
     }
 
-    vector<int> DNASearchEngine::naive_search(const string &text, const string &pattern, int &comparisons)
+    void DNASearchEngine::simd_search(const PackedSequence &text, const string &pattern, MatchList &matches,
+                                      uint64_t &comparisons)
     {
-        vector<int> matches;
-        int n = text.length();
-        int m = pattern.length();
+        size_t n = text.size();
+        size_t m = pattern.length();
+        comparisons = 0;
+
+        if (m == 0 || n < m)
+        {
+            return;
+        }
+
+        // Decode a block at a time into a byte buffer the vector kernel can scan.
+        // Blocks overlap by m - 1 bases, so a match belongs to the block it starts in.
+        const size_t block_size = 1 << 20;
+        vector<char> buffer(block_size + m - 1);
+
+        for (size_t begin = 0; begin + m <= n; begin += block_size)
+        {
+            size_t length = min(n - begin, block_size + m - 1);
+            text.decode(begin, length, buffer.data());
+            simd::find_all(buffer.data(), length, pattern, begin, matches, comparisons);
+        }
+    }
+
+    void DNASearchEngine::naive_search(const PackedSequence &text, const string &pattern, MatchList &matches,
+                                       uint64_t &comparisons)
+    {
+        size_t n = text.size();
+        size_t m = pattern.length();
         comparisons = 0;
 
         if (m == 0)
         {
-            return matches;
+            return;
         }
 
         if (n < m)
         {
-            return matches;
+            return;
         }
 
-        for (int i = 0; i <= n - m; ++i)
+        for (size_t i = 0; i <= n - m; ++i)
         {
             bool match = true;
+            PackedSequence::Cursor reader = text.cursor(i);
 
-            for (int j = 0; j < m; ++j)
+            for (size_t j = 0; j < m; ++j)
             {
                 comparisons++;
-                if (text[i + j] != pattern[j])
+                if (reader.next() != pattern[j])
                 {
                     match = false;
                     break;
@@ -201,8 +920,6 @@ namespace dna
                 matches.push_back(i);
             }
         }
-
-        return matches;
     }
 
     bool DNASearchEngine::export_results(const string &filename)
@@ -211,11 +928,74 @@ namespace dna
 
         exporter.add_int("dna_length", m_dna_sequence.size());
         exporter.add_string("pattern", m_pattern);
-        exporter.add_int_array("matches", m_matches);
+        exporter.add_int("match_count", m_matches.size());
+        if (m_matches.count_only())
+        {
+            exporter.add_bool("count_only", true);
+        }
+        else
+        {
+            exporter.add_int_range("matches", m_matches.begin(), m_matches.end());
+        }
         exporter.add_int("comparisons", m_comparisons);
         exporter.add_double("execution_time_ms", m_execution_time_ms);
         exporter.add_string("algorithm", m_algorithm);
 
+        if (!m_strands.empty())
+        {
+            vector<string> strands;
+            for (char strand : m_strands)
+            {
+                strands.push_back(string(1, strand));
+            }
+            exporter.add_string_array("strands", strands);
+        }
+
+        if (!m_approximate_matches.empty())
+        {
+            exporter.add_int("max_errors", m_max_errors);
+            exporter.start_array("approximate_matches");
+            for (size_t i = 0; i < m_approximate_matches.size(); ++i)
+            {
+                map<string, string> match_obj = {
+                    {"position", to_string(m_approximate_matches[i].position)},
+                    {"distance", to_string(m_approximate_matches[i].distance)},
+                    {"length", to_string(m_approximate_matches[i].length)}};
+                exporter.add_object_to_array(match_obj, i == m_approximate_matches.size() - 1);
+            }
+            exporter.end_array();
+        }
+
+        if (!m_pattern_hits.empty())
+        {
+            exporter.start_array("pattern_results");
+            for (size_t i = 0; i < m_pattern_hits.size(); ++i)
+            {
+                exporter.start_object();
+                exporter.add_string("name", m_pattern_hits[i].name);
+                exporter.add_string("pattern", m_pattern_hits[i].pattern);
+                exporter.add_int("count", m_pattern_hits[i].matches.size());
+                if (!m_pattern_hits[i].matches.count_only())
+                {
+                    exporter.add_int_range("matches", m_pattern_hits[i].matches.begin(),
+                                           m_pattern_hits[i].matches.end());
+                }
+                exporter.end_object(i == m_pattern_hits.size() - 1);
+            }
+            exporter.end_array();
+        }
+
+        exporter.start_array("contigs");
+        for (size_t i = 0; i < m_contigs.size(); ++i)
+        {
+            map<string, string> contig_obj = {
+                {"name", m_contigs[i].name},
+                {"offset", to_string(m_contigs[i].offset)},
+                {"length", to_string(m_contigs[i].length)}};
+            exporter.add_object_to_array(contig_obj, i == m_contigs.size() - 1);
+        }
+        exporter.end_array();
+
         return exporter.export_to_file(filename);
     }
 
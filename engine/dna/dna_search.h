@@ -1,47 +1,147 @@
 #ifndef DNA_SEARCH_H
 #define DNA_SEARCH_H
 
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 #include <chrono>
 #include <fstream>
 #include <iostream>
 #include "../utils/json_exporter.h"
+#include "packed_sequence.h"
+#include "match_list.h"
+#include "fm_index.h"
+#include "aho_corasick.h"
+#include "simd_search.h"
+#include "approximate_search.h"
+#include "iupac_search.h"
 
 namespace dna
 {
 
+    // One FASTA record, addressed as a slice of the concatenated sequence
+    struct Contig
+    {
+        std::string name;
+        size_t offset;
+        size_t length;
+
+        Contig(const std::string &contig_name, size_t start)
+            : name(contig_name), offset(start), length(0) {}
+    };
+
+    // Hits of one pattern from a multi-pattern search
+    struct PatternHits
+    {
+        std::string name;
+        std::string pattern;
+        MatchList matches;
+    };
+
     class DNASearchEngine
     {
     public:
         DNASearchEngine() = default;
         ~DNASearchEngine() = default;
 
-        // Load DNA sequence from FASTA file
+        // Load DNA sequence from FASTA file (every record becomes a contig)
         bool load_fasta(const std::string &filename);
 
-        // Search for a pattern using specified algorithm
+        // Records of the loaded FASTA file, in file order
+        const std::vector<Contig> &get_contigs() const { return m_contigs; }
+
+        // Index of the contig containing a position of the concatenated sequence
+        size_t find_contig(size_t position) const;
+
+        // Only count hits instead of storing their positions (for very frequent motifs)
+        void set_count_only(bool count_only) { m_count_only = count_only; }
+
+        // Search for a pattern using specified algorithm ("KMP", "parallel-KMP", "naive", "SIMD" or "FM-index")
         void search_pattern(const std::string &pattern, const std::string &algorithm);
 
+        // Find occurrences with up to max_errors errors; mode is "hamming" (mismatches only)
+        // or "edit" (mismatches, insertions and deletions). Patterns are limited to 64 bases.
+        void search_approximate(const std::string &pattern, int max_errors, const std::string &mode);
+
+        // Search for a degenerate (IUPAC) pattern of up to 64 bases on the forward and,
+        // optionally, the reverse strand in one pass; the strand is recorded per hit
+        void search_degenerate(const std::string &pattern, bool both_strands = true);
+
+        // Search a FASTA file without loading it: blocks are read on a background thread,
+        // the KMP state carries across block boundaries and matches are written to
+        // output_filename as they are found, so memory stays bounded by the block size
+        bool stream_search(const std::string &fasta_filename, const std::string &pattern,
+                           const std::string &output_filename);
+
+        // Search for a whole panel of patterns in a single pass (Aho-Corasick).
+        // Names label the patterns in the export; the patterns themselves are used if omitted.
+        void search_patterns(const std::vector<std::string> &patterns, const std::vector<std::string> &names = {});
+
+        // Read a panel of probes from a FASTA file and search for all of them
+        bool search_pattern_file(const std::string &filename);
+
+        // Build the FM-index over the loaded sequence (done on demand by "FM-index" searches)
+        bool build_index();
+
+        // Persist the FM-index, or reuse one saved for the same sequence
+        bool save_index(const std::string &filename) const;
+        bool load_index(const std::string &filename);
+
+        // Time every algorithm over a set of patterns and export the comparison to JSON
+        bool benchmark(const std::vector<std::string> &patterns, const std::string &filename);
+
         // Export results to JSON
         bool export_results(const std::string &filename);
 
     private:
-        std::string m_dna_sequence;
+        PackedSequence m_dna_sequence;
+        std::vector<Contig> m_contigs;
+        std::shared_ptr<const std::vector<uint64_t>> m_contig_ends; // Only set for multi-record files
         std::string m_pattern;
         std::string m_algorithm;
-        std::vector<int> m_matches;
-        int m_comparisons;
-        double m_execution_time_ms;
+        MatchList m_matches;
+        bool m_count_only = false;
+        std::vector<char> m_strands; // Per match, only filled by strand-aware searches
+        std::vector<PatternHits> m_pattern_hits;
+        std::vector<ApproximateMatch> m_approximate_matches;
+        int m_max_errors = 0;
+        uint64_t m_comparisons = 0;
+        double m_execution_time_ms = 0;
+        FMIndex m_index;
+
+        // Empty match list in the current mode that drops hits straddling two contigs
+        MatchList new_match_list(size_t pattern_length, bool count_only) const;
 
         // KMP algorithm implementation
-        std::vector<int> kmp_search(const std::string &text, const std::string &pattern, int &comparisons);
+        void kmp_search(const PackedSequence &text, const std::string &pattern, MatchList &matches,
+                        uint64_t &comparisons);
+
+        // Multithreaded KMP over overlapping chunks of the sequence
+        void parallel_kmp_search(const PackedSequence &text, const std::string &pattern, MatchList &matches,
+                                 uint64_t &comparisons);
+
+        // KMP matcher over text positions [begin, end), starting from an empty match state
+        void kmp_scan(const PackedSequence &text, const std::string &pattern, const std::vector<int> &pi,
+                      size_t begin, size_t end, MatchList &matches, uint64_t &comparisons);
+
+        // Vectorized first/last-byte filter over decoded blocks of the sequence
+        void simd_search(const PackedSequence &text, const std::string &pattern, MatchList &matches,
+                         uint64_t &comparisons);
 
         // Compute KMP prefix function
         std::vector<int> compute_prefix_function(const std::string &pattern);
 
         // Naive search algorithm for comparison
-        std::vector<int> naive_search(const std::string &text, const std::string &pattern, int &comparisons);
+        void naive_search(const PackedSequence &text, const std::string &pattern, MatchList &matches,
+                          uint64_t &comparisons);
+
+        // FM-index lookup, same contract as the scanning algorithms
+        void index_search(const std::string &pattern, MatchList &matches, uint64_t &comparisons);
+
+        // Run one of the algorithms by name
+        void run_algorithm(const std::string &algorithm, const std::string &pattern, MatchList &matches,
+                           uint64_t &comparisons);
     };
 
 } // namespace dna
@@ -0,0 +1,378 @@
+#include "fm_index.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+
+using namespace std;
+
+namespace dna
+{
+
+    namespace
+    {
+        const char INDEX_MAGIC[8] = {'B', 'S', 'E', 'F', 'M', 'I', 'D', 'X'};
+        const uint32_t INDEX_VERSION = 2; // 2: sequence checksum in the header
+
+        template <typename T>
+        void write_vector(ofstream &file, const vector<T> &values)
+        {
+            uint64_t size = values.size();
+            file.write(reinterpret_cast<const char *>(&size), sizeof(size));
+            file.write(reinterpret_cast<const char *>(values.data()), size * sizeof(T));
+        }
+
+        // file_size bounds the stored size, so a corrupt size cannot trigger
+        // a huge allocation
+        template <typename T>
+        bool read_vector(ifstream &file, uint64_t file_size, vector<T> &values)
+        {
+            uint64_t size = 0;
+            if (!file.read(reinterpret_cast<char *>(&size), sizeof(size)))
+            {
+                return false;
+            }
+            uint64_t position = static_cast<uint64_t>(file.tellg());
+            if (position > file_size || size > (file_size - position) / sizeof(T))
+            {
+                return false;
+            }
+            values.resize(size);
+            return static_cast<bool>(file.read(reinterpret_cast<char *>(values.data()), size * sizeof(T)));
+        }
+    }
+
+    uint8_t FMIndex::symbol(char base)
+    {
+        switch (base)
+        {
+        case 'A':
+            return 1;
+        case 'C':
+            return 2;
+        case 'G':
+            return 3;
+        case 'T':
+            return 4;
+        default:
+            return 5;
+        }
+    }
+
+    bool FMIndex::is_searchable(const string &pattern)
+    {
+        for (char c : pattern)
+        {
+            if (symbol(c) == 5)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool FMIndex::build(const PackedSequence &text)
+    {
+        // Suffix array entries are 32-bit to keep the index at ~5.5 bytes per base
+        if (text.size() >= numeric_limits<uint32_t>::max())
+        {
+            cerr << "Error: Sequence too long for the FM-index (" << text.size() << " bases)" << endl;
+            return false;
+        }
+
+        size_t n = text.size() + 1;
+
+        // Symbol string with the sentinel at the end
+        vector<uint8_t> symbols(n);
+        PackedSequence::Cursor reader = text.cursor();
+        for (size_t i = 0; i + 1 < n; ++i)
+        {
+            symbols[i] = symbol(reader.next());
+        }
+        symbols[n - 1] = 0;
+
+        // Prefix doubling: after the round for k, suffixes are sorted by their
+        // first 2k symbols. Each round is two linear passes with a counting sort.
+        vector<uint32_t> sa(n), rank(n), order(n), counts;
+
+        counts.assign(ALPHABET_SIZE, 0);
+        for (size_t i = 0; i < n; ++i)
+        {
+            counts[symbols[i]]++;
+        }
+        for (size_t c = 1; c < counts.size(); ++c)
+        {
+            counts[c] += counts[c - 1];
+        }
+        for (size_t i = n; i-- > 0;)
+        {
+            sa[--counts[symbols[i]]] = static_cast<uint32_t>(i);
+        }
+
+        rank[sa[0]] = 0;
+        for (size_t i = 1; i < n; ++i)
+        {
+            rank[sa[i]] = rank[sa[i - 1]] + (symbols[sa[i]] != symbols[sa[i - 1]]);
+        }
+        symbols.clear();
+        symbols.shrink_to_fit();
+
+        for (size_t k = 1; rank[sa[n - 1]] < n - 1; k <<= 1)
+        {
+            // Order by second key: suffixes shorter than k first (they already
+            // contain the unique sentinel), then the rest in current SA order
+            size_t p = 0;
+            for (size_t i = n - k; i < n; ++i)
+            {
+                order[p++] = static_cast<uint32_t>(i);
+            }
+            for (size_t i = 0; i < n; ++i)
+            {
+                if (sa[i] >= k)
+                {
+                    order[p++] = static_cast<uint32_t>(sa[i] - k);
+                }
+            }
+
+            // Stable counting sort by first key
+            counts.assign(rank[sa[n - 1]] + 1, 0);
+            for (size_t i = 0; i < n; ++i)
+            {
+                counts[rank[i]]++;
+            }
+            for (size_t r = 1; r < counts.size(); ++r)
+            {
+                counts[r] += counts[r - 1];
+            }
+            for (size_t i = n; i-- > 0;)
+            {
+                sa[--counts[rank[order[i]]]] = order[i];
+            }
+
+            // Re-rank by (first key, second key)
+            auto second_key = [&](uint32_t pos) -> int64_t
+            {
+                return pos + k < n ? static_cast<int64_t>(rank[pos + k]) : -1;
+            };
+            order[sa[0]] = 0;
+            for (size_t i = 1; i < n; ++i)
+            {
+                bool differs = rank[sa[i]] != rank[sa[i - 1]] || second_key(sa[i]) != second_key(sa[i - 1]);
+                order[sa[i]] = order[sa[i - 1]] + differs;
+            }
+            rank.swap(order);
+        }
+
+        rank.clear();
+        rank.shrink_to_fit();
+        order.clear();
+        order.shrink_to_fit();
+
+        // BWT and occurrence checkpoints
+        m_length = n;
+        m_text_checksum = text.checksum();
+        m_bwt.assign(n, 0);
+        m_occ.assign(((n + OCC_INTERVAL - 1) / OCC_INTERVAL + 1) * ALPHABET_SIZE, 0);
+
+        uint64_t running[ALPHABET_SIZE] = {0};
+        for (size_t i = 0; i < n; ++i)
+        {
+            if (i % OCC_INTERVAL == 0)
+            {
+                copy(running, running + ALPHABET_SIZE, m_occ.begin() + (i / OCC_INTERVAL) * ALPHABET_SIZE);
+            }
+
+            m_bwt[i] = sa[i] == 0 ? 0 : symbol(text.at(sa[i] - 1));
+            running[m_bwt[i]]++;
+        }
+
+        // A search starts at hi = n, which needs its own checkpoint when n is a multiple
+        if (n % OCC_INTERVAL == 0)
+        {
+            copy(running, running + ALPHABET_SIZE, m_occ.begin() + (n / OCC_INTERVAL) * ALPHABET_SIZE);
+        }
+
+        m_first[0] = 0;
+        for (int c = 0; c < ALPHABET_SIZE; ++c)
+        {
+            m_first[c + 1] = m_first[c] + running[c];
+        }
+
+        m_suffix_array.swap(sa);
+        return true;
+    }
+
+    uint64_t FMIndex::occ(uint8_t c, size_t pos) const
+    {
+        size_t block = pos / OCC_INTERVAL;
+        uint64_t result = m_occ[block * ALPHABET_SIZE + c];
+
+        const uint8_t *bwt = m_bwt.data();
+        for (size_t i = block * OCC_INTERVAL; i < pos; ++i)
+        {
+            result += bwt[i] == c;
+        }
+        return result;
+    }
+
+    void FMIndex::backward_search(const string &pattern, size_t &lo, size_t &hi, uint64_t &steps) const
+    {
+        lo = 0;
+        hi = m_length;
+
+        for (size_t i = pattern.length(); i-- > 0 && lo < hi;)
+        {
+            uint8_t c = symbol(pattern[i]);
+            lo = m_first[c] + occ(c, lo);
+            hi = m_first[c] + occ(c, hi);
+            steps++;
+        }
+    }
+
+    size_t FMIndex::count(const string &pattern, uint64_t &steps) const
+    {
+        if (empty() || pattern.empty() || !is_searchable(pattern))
+        {
+            return 0;
+        }
+
+        size_t lo, hi;
+        backward_search(pattern, lo, hi, steps);
+        return lo < hi ? hi - lo : 0;
+    }
+
+    vector<size_t> FMIndex::locate(const string &pattern, uint64_t &steps) const
+    {
+        vector<size_t> positions;
+        if (empty() || pattern.empty() || !is_searchable(pattern))
+        {
+            return positions;
+        }
+
+        size_t lo, hi;
+        backward_search(pattern, lo, hi, steps);
+        if (lo < hi)
+        {
+            // Suffix array order is not text order; a single hit needs no sort
+            positions.assign(m_suffix_array.begin() + lo, m_suffix_array.begin() + hi);
+            if (positions.size() > 1)
+            {
+                sort(positions.begin(), positions.end());
+            }
+        }
+        return positions;
+    }
+
+    bool FMIndex::save(const string &filename) const
+    {
+        ofstream file(filename, ios::binary);
+        if (!file.is_open())
+        {
+            cerr << "Error: Could not open file " << filename << endl;
+            return false;
+        }
+
+        uint64_t length = m_length;
+        file.write(INDEX_MAGIC, sizeof(INDEX_MAGIC));
+        file.write(reinterpret_cast<const char *>(&INDEX_VERSION), sizeof(INDEX_VERSION));
+        file.write(reinterpret_cast<const char *>(&length), sizeof(length));
+        file.write(reinterpret_cast<const char *>(&m_text_checksum), sizeof(m_text_checksum));
+        file.write(reinterpret_cast<const char *>(m_first), sizeof(m_first));
+        write_vector(file, m_bwt);
+        write_vector(file, m_occ);
+        write_vector(file, m_suffix_array);
+
+        return static_cast<bool>(file);
+    }
+
+    bool FMIndex::load(const string &filename)
+    {
+        ifstream file(filename, ios::binary);
+        if (!file.is_open())
+        {
+            cerr << "Error: Could not open file " << filename << endl;
+            return false;
+        }
+
+        file.seekg(0, ios::end);
+        uint64_t file_size = static_cast<uint64_t>(file.tellg());
+        file.seekg(0, ios::beg);
+
+        char magic[sizeof(INDEX_MAGIC)];
+        uint32_t version = 0;
+        uint64_t length = 0;
+        uint64_t checksum = 0;
+
+        if (!file.read(magic, sizeof(magic)) || memcmp(magic, INDEX_MAGIC, sizeof(magic)) != 0 ||
+            !file.read(reinterpret_cast<char *>(&version), sizeof(version)) || version != INDEX_VERSION)
+        {
+            cerr << "Error: " << filename << " is not a supported FM-index file" << endl;
+            return false;
+        }
+
+        // Read into new arrays, so a bad file leaves the current index untouched
+        uint64_t first[ALPHABET_SIZE + 1];
+        vector<uint8_t> bwt;
+        vector<uint64_t> occ_table;
+        vector<uint32_t> suffix_array;
+        bool valid = file.read(reinterpret_cast<char *>(&length), sizeof(length)) &&
+                     file.read(reinterpret_cast<char *>(&checksum), sizeof(checksum)) &&
+                     file.read(reinterpret_cast<char *>(first), sizeof(first)) &&
+                     read_vector(file, file_size, bwt) && read_vector(file, file_size, occ_table) &&
+                     read_vector(file, file_size, suffix_array) &&
+                     length > 0 && bwt.size() == length && suffix_array.size() == length &&
+                     occ_table.size() == ((length + OCC_INTERVAL - 1) / OCC_INTERVAL + 1) * ALPHABET_SIZE;
+
+        // Backward search indexes the suffix array with values derived from the
+        // C array and the checkpoints, so both must agree with the BWT exactly
+        uint64_t running[ALPHABET_SIZE] = {0};
+        for (size_t i = 0; valid && i < length; ++i)
+        {
+            if (i % OCC_INTERVAL == 0)
+            {
+                valid = equal(running, running + ALPHABET_SIZE, occ_table.begin() + (i / OCC_INTERVAL) * ALPHABET_SIZE);
+            }
+            valid = valid && bwt[i] < ALPHABET_SIZE && suffix_array[i] < length;
+            if (valid)
+            {
+                running[bwt[i]]++;
+            }
+        }
+        if (valid && length % OCC_INTERVAL == 0)
+        {
+            valid = equal(running, running + ALPHABET_SIZE, occ_table.begin() + (length / OCC_INTERVAL) * ALPHABET_SIZE);
+        }
+        valid = valid && first[0] == 0;
+        for (int c = 0; valid && c < ALPHABET_SIZE; ++c)
+        {
+            valid = first[c + 1] == first[c] + running[c];
+        }
+
+        // The suffix array must follow the LF mapping: row i, preceded by
+        // bwt[i], maps to the row of the suffix one position earlier
+        fill(running, running + ALPHABET_SIZE, 0);
+        for (size_t i = 0; valid && i < length; ++i)
+        {
+            uint8_t c = bwt[i];
+            valid = c == 0 ? suffix_array[i] == 0
+                           : suffix_array[i] > 0 && suffix_array[first[c] + running[c]] == suffix_array[i] - 1;
+            running[c]++;
+        }
+
+        if (!valid)
+        {
+            cerr << "Error: FM-index file " << filename << " is truncated or corrupt" << endl;
+            return false;
+        }
+
+        m_length = length;
+        m_text_checksum = checksum;
+        copy(first, first + ALPHABET_SIZE + 1, m_first);
+        m_bwt.swap(bwt);
+        m_occ.swap(occ_table);
+        m_suffix_array.swap(suffix_array);
+        return true;
+    }
+
+} // namespace dna
@@ -0,0 +1,73 @@
+#ifndef FM_INDEX_H
+#define FM_INDEX_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "packed_sequence.h"
+
+namespace dna
+{
+
+    // FM-index over a DNA sequence: Burrows-Wheeler transform with sampled
+    // occurrence counts for backward search, plus the full suffix array so that
+    // every hit can be located in O(1). A count query costs O(m) and a locate
+    // query O(m + occ log occ), since the hits come out in suffix array order
+    // and are sorted by position; both are independent of the sequence length.
+    class FMIndex
+    {
+    public:
+        FMIndex() : m_length(0), m_text_checksum(0) {}
+        ~FMIndex() = default;
+
+        // Build the index over a sequence (suffix array by prefix doubling)
+        bool build(const PackedSequence &text);
+
+        // Persist the index to / restore it from a binary file
+        bool save(const std::string &filename) const;
+        bool load(const std::string &filename);
+
+        bool empty() const { return m_length == 0; }
+
+        // Length of the indexed sequence (without the sentinel)
+        size_t text_length() const { return m_length == 0 ? 0 : m_length - 1; }
+
+        // PackedSequence::checksum() of the indexed sequence
+        uint64_t text_checksum() const { return m_text_checksum; }
+
+        // Whether a pattern only uses symbols the index can search (A, C, G, T)
+        static bool is_searchable(const std::string &pattern);
+
+        // Number of occurrences of a pattern; steps counts backward-search steps
+        size_t count(const std::string &pattern, uint64_t &steps) const;
+
+        // Sorted start positions of every occurrence of a pattern; callers that
+        // only need the number of hits should use count() and skip the sort
+        std::vector<size_t> locate(const std::string &pattern, uint64_t &steps) const;
+
+    private:
+        // Symbols: 0 = sentinel, 1-4 = A/C/G/T, 5 = any other character
+        static const int ALPHABET_SIZE = 6;
+
+        // One occurrence checkpoint every OCC_INTERVAL BWT positions
+        static const size_t OCC_INTERVAL = 128;
+
+        size_t m_length;                        // Indexed length including the sentinel
+        uint64_t m_text_checksum;               // Checksum of the indexed sequence
+        uint64_t m_first[ALPHABET_SIZE + 1];    // C array: first BWT row of each symbol
+        std::vector<uint8_t> m_bwt;             // BWT, one symbol per byte
+        std::vector<uint64_t> m_occ;            // ALPHABET_SIZE counts per checkpoint
+        std::vector<uint32_t> m_suffix_array;   // Full suffix array
+
+        static uint8_t symbol(char base);
+
+        // Number of occurrences of a symbol in m_bwt[0, pos)
+        uint64_t occ(uint8_t c, size_t pos) const;
+
+        // Backward search: half-open suffix array range [lo, hi) of a pattern
+        void backward_search(const std::string &pattern, size_t &lo, size_t &hi, uint64_t &steps) const;
+    };
+
+} // namespace dna
+
+#endif // FM_INDEX_H
@@ -0,0 +1,183 @@
+#include "iupac_search.h"
+#include <cstdint>
+
+using namespace std;
+
+namespace dna
+{
+    namespace iupac
+    {
+
+        namespace
+        {
+            const uint8_t BASE_A = 1, BASE_C = 2, BASE_G = 4, BASE_T = 8;
+
+            // Set of bases an IUPAC code stands for (0 for anything else)
+            uint8_t base_set(char code)
+            {
+                switch (code)
+                {
+                case 'A':
+                    return BASE_A;
+                case 'C':
+                    return BASE_C;
+                case 'G':
+                    return BASE_G;
+                case 'T':
+                case 'U':
+                    return BASE_T;
+                case 'R':
+                    return BASE_A | BASE_G;
+                case 'Y':
+                    return BASE_C | BASE_T;
+                case 'S':
+                    return BASE_C | BASE_G;
+                case 'W':
+                    return BASE_A | BASE_T;
+                case 'K':
+                    return BASE_G | BASE_T;
+                case 'M':
+                    return BASE_A | BASE_C;
+                case 'B':
+                    return BASE_C | BASE_G | BASE_T;
+                case 'D':
+                    return BASE_A | BASE_G | BASE_T;
+                case 'H':
+                    return BASE_A | BASE_C | BASE_T;
+                case 'V':
+                    return BASE_A | BASE_C | BASE_G;
+                case 'N':
+                    return BASE_A | BASE_C | BASE_G | BASE_T;
+                default:
+                    return 0;
+                }
+            }
+
+            char complement(char code)
+            {
+                switch (code)
+                {
+                case 'A':
+                    return 'T';
+                case 'T':
+                case 'U':
+                    return 'A';
+                case 'C':
+                    return 'G';
+                case 'G':
+                    return 'C';
+                case 'R':
+                    return 'Y';
+                case 'Y':
+                    return 'R';
+                case 'K':
+                    return 'M';
+                case 'M':
+                    return 'K';
+                case 'B':
+                    return 'V';
+                case 'V':
+                    return 'B';
+                case 'D':
+                    return 'H';
+                case 'H':
+                    return 'D';
+                default:
+                    return code; // S, W and N are their own complement
+                }
+            }
+
+            // masks[c] bit i: text character c is compatible with pattern[i]. A text
+            // character matches when every base it may stand for is allowed, so an
+            // N in the pattern accepts anything but an N in the text only matches N.
+            void build_masks(const string &pattern, uint64_t masks[256])
+            {
+                for (int c = 0; c < 256; ++c)
+                {
+                    masks[c] = 0;
+                    uint8_t text_set = base_set(static_cast<char>(c));
+                    if (text_set == 0)
+                    {
+                        continue;
+                    }
+
+                    for (size_t i = 0; i < pattern.length(); ++i)
+                    {
+                        if ((text_set & ~base_set(pattern[i])) == 0)
+                        {
+                            masks[c] |= uint64_t(1) << i;
+                        }
+                    }
+                }
+            }
+        }
+
+        bool is_valid_pattern(const string &pattern)
+        {
+            for (char c : pattern)
+            {
+                if (base_set(c) == 0)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        string reverse_complement(const string &pattern)
+        {
+            string result(pattern.rbegin(), pattern.rend());
+            for (char &c : result)
+            {
+                c = complement(c);
+            }
+            return result;
+        }
+
+        vector<StrandMatch> search(const PackedSequence &text, const string &pattern,
+                                   bool both_strands, uint64_t &operations)
+        {
+            vector<StrandMatch> matches;
+            size_t n = text.size();
+            size_t m = pattern.length();
+            operations = 0;
+
+            if (m == 0 || m > MAX_PATTERN_LENGTH || n < m)
+            {
+                return matches;
+            }
+
+            // A reverse-complement palindrome would report every hit twice
+            string reverse = reverse_complement(pattern);
+            bool scan_reverse = both_strands && reverse != pattern;
+
+            uint64_t forward_masks[256], reverse_masks[256];
+            build_masks(pattern, forward_masks);
+            build_masks(reverse, reverse_masks);
+
+            uint64_t forward_state = 0, reverse_state = 0;
+            const uint64_t accept = uint64_t(1) << (m - 1);
+            PackedSequence::Cursor reader = text.cursor();
+
+            for (size_t j = 0; j < n; ++j)
+            {
+                unsigned char c = static_cast<unsigned char>(reader.next());
+                forward_state = ((forward_state << 1) | 1) & forward_masks[c];
+                reverse_state = ((reverse_state << 1) | 1) & reverse_masks[c];
+                operations++;
+
+                if (forward_state & accept)
+                {
+                    matches.push_back({j + 1 - m, '+'});
+                }
+                if (scan_reverse && (reverse_state & accept))
+                {
+                    matches.push_back({j + 1 - m, '-'});
+                }
+            }
+
+            return matches;
+        }
+
+    } // namespace iupac
+} // namespace dna
@@ -0,0 +1,42 @@
+#ifndef IUPAC_SEARCH_H
+#define IUPAC_SEARCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "packed_sequence.h"
+
+namespace dna
+{
+
+    // Hit of a degenerate pattern on one strand. Positions are always on the
+    // forward strand; '-' means the reverse complement of the pattern matched.
+    struct StrandMatch
+    {
+        size_t position;
+        char strand;
+    };
+
+    // Degenerate (IUPAC) pattern search on both strands in a single scan. Each
+    // pattern position becomes a bit in a per-base mask (bit i of mask[c] is set
+    // when base c is allowed at position i), and Shift-And runs the forward and
+    // reverse-complement masks side by side. Patterns are limited to 64 bases.
+    namespace iupac
+    {
+        const size_t MAX_PATTERN_LENGTH = 64;
+
+        // Whether every character is an IUPAC nucleotide code
+        bool is_valid_pattern(const std::string &pattern);
+
+        // Reverse complement of an (upper-case) IUPAC pattern
+        std::string reverse_complement(const std::string &pattern);
+
+        // Sorted hits of the pattern, on the forward strand and (optionally) the reverse strand
+        std::vector<StrandMatch> search(const PackedSequence &text, const std::string &pattern,
+                                        bool both_strands, uint64_t &operations);
+    }
+
+} // namespace dna
+
+#endif // IUPAC_SEARCH_H
@@ -0,0 +1,186 @@
+#ifndef MATCH_LIST_H
+#define MATCH_LIST_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+namespace dna
+{
+
+    // Sorted list of 64-bit match positions stored as varint-encoded deltas,
+    // so dense hits (e.g. "TA") cost one or two bytes each instead of eight.
+    // In count-only mode nothing is stored and only the number of hits is kept.
+    class MatchList
+    {
+    public:
+        explicit MatchList(bool count_only = false)
+            : m_count(0), m_last(0), m_count_only(count_only), m_match_length(0), m_segment(0) {}
+
+        // Forward iterator decoding the positions in order
+        class const_iterator
+        {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = uint64_t;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const uint64_t *;
+            using reference = const uint64_t &;
+
+            const_iterator(const uint8_t *data, size_t offset, size_t size)
+                : m_data(data), m_offset(offset), m_size(size), m_value(0), m_next_offset(offset)
+            {
+                decode();
+            }
+
+            reference operator*() const { return m_value; }
+
+            const_iterator &operator++()
+            {
+                m_offset = m_next_offset;
+                decode();
+                return *this;
+            }
+
+            bool operator==(const const_iterator &other) const { return m_offset == other.m_offset; }
+            bool operator!=(const const_iterator &other) const { return m_offset != other.m_offset; }
+
+        private:
+            const uint8_t *m_data;
+            size_t m_offset;
+            size_t m_size;
+            uint64_t m_value;
+            size_t m_next_offset;
+
+            // Read the delta at m_offset and add it to the running position
+            void decode()
+            {
+                if (m_offset >= m_size)
+                {
+                    return;
+                }
+
+                uint64_t delta = 0;
+                int shift = 0;
+                size_t offset = m_offset;
+                uint8_t byte;
+                do
+                {
+                    byte = m_data[offset++];
+                    delta |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                    shift += 7;
+                } while (byte & 0x80);
+
+                m_value += delta;
+                m_next_offset = offset;
+            }
+        };
+
+        // Drop matches of match_length bases that would run past one of the
+        // (sorted) segment ends, e.g. hits straddling two FASTA records
+        void set_boundaries(std::shared_ptr<const std::vector<uint64_t>> segment_ends, uint64_t match_length)
+        {
+            m_segment_ends = std::move(segment_ends);
+            m_match_length = match_length;
+            m_segment = 0;
+        }
+
+        // Empty list with the same mode and boundaries
+        MatchList with_same_settings() const
+        {
+            MatchList list(m_count_only);
+            list.set_boundaries(m_segment_ends, m_match_length);
+            return list;
+        }
+
+        // Record a match; positions must be added in non-decreasing order.
+        // Returns false if the boundary check dropped it.
+        bool push_back(uint64_t position)
+        {
+            if (m_segment_ends)
+            {
+                const std::vector<uint64_t> &ends = *m_segment_ends;
+                while (m_segment < ends.size() && position >= ends[m_segment])
+                {
+                    m_segment++;
+                }
+                if (m_segment < ends.size() && position + m_match_length > ends[m_segment])
+                {
+                    return false;
+                }
+            }
+
+            if (!m_count_only)
+            {
+                uint64_t delta = position - m_last;
+                while (delta >= 0x80)
+                {
+                    m_bytes.push_back(static_cast<uint8_t>(delta | 0x80));
+                    delta >>= 7;
+                }
+                m_bytes.push_back(static_cast<uint8_t>(delta));
+                m_last = position;
+            }
+
+            m_count++;
+            return true;
+        }
+
+        // Count-only lists: record hits that were counted elsewhere (no boundary check)
+        void add_count(uint64_t count)
+        {
+            m_count += count;
+        }
+
+        // Append a list made with the same settings whose positions all follow ours
+        void append(const MatchList &other)
+        {
+            if (other.m_count_only)
+            {
+                m_count += other.m_count;
+                return;
+            }
+
+            for (uint64_t position : other)
+            {
+                push_back(position);
+            }
+        }
+
+        void clear()
+        {
+            m_bytes.clear();
+            m_count = 0;
+            m_last = 0;
+            m_segment = 0;
+        }
+
+        uint64_t size() const { return m_count; }
+        bool empty() const { return m_count == 0; }
+        bool count_only() const { return m_count_only; }
+
+        // Heap bytes used by the encoded positions
+        size_t memory_usage() const { return m_bytes.capacity(); }
+
+        const_iterator begin() const { return const_iterator(m_bytes.data(), 0, m_bytes.size()); }
+        const_iterator end() const { return const_iterator(m_bytes.data(), m_bytes.size(), m_bytes.size()); }
+
+        // Decoded copy of the positions
+        std::vector<uint64_t> to_vector() const { return std::vector<uint64_t>(begin(), end()); }
+
+    private:
+        std::vector<uint8_t> m_bytes;
+        uint64_t m_count;
+        uint64_t m_last;
+        bool m_count_only;
+
+        std::shared_ptr<const std::vector<uint64_t>> m_segment_ends;
+        uint64_t m_match_length;
+        size_t m_segment; // First segment whose end lies after the last position checked
+    };
+
+} // namespace dna
+
+#endif // MATCH_LIST_H
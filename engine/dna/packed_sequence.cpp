@@ -0,0 +1,299 @@
+#include "packed_sequence.h"
+#include <algorithm>
+#include <cctype>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define DNA_SIMD_X86 1
+#include <emmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+using namespace std;
+
+namespace dna
+{
+
+    constexpr char PackedSequence::BASES[4];
+
+    PackedSequence::Cursor::Cursor(const PackedSequence &sequence, size_t pos)
+        : m_sequence(&sequence), m_pos(pos), m_exception(sequence.find_exception(pos))
+    {
+    }
+
+    int PackedSequence::encode(char base)
+    {
+        switch (base)
+        {
+        case 'A':
+            return 0;
+        case 'C':
+            return 1;
+        case 'G':
+            return 2;
+        case 'T':
+            return 3;
+        default:
+            return -1;
+        }
+    }
+
+    void PackedSequence::clear()
+    {
+        m_words.clear();
+        m_exceptions.clear();
+        m_size = 0;
+    }
+
+    void PackedSequence::reserve(size_t bases)
+    {
+        m_words.reserve((bases + 31) / 32);
+    }
+
+    // Byte classification used by append(): 0-3 are packed codes, EXCEPTION marks
+    // any other printable character and SKIP marks whitespace/control characters
+    namespace
+    {
+        const uint8_t EXCEPTION = 4;
+        const uint8_t SKIP = 5;
+
+        struct CodeTable
+        {
+            uint8_t codes[256];
+
+            CodeTable()
+            {
+                for (int c = 0; c < 256; ++c)
+                {
+                    codes[c] = (c > ' ' && c < 127) ? EXCEPTION : SKIP;
+                }
+                codes['A'] = codes['a'] = 0;
+                codes['C'] = codes['c'] = 1;
+                codes['G'] = codes['g'] = 2;
+                codes['T'] = codes['t'] = 3;
+            }
+        };
+
+        const CodeTable CODE_TABLE;
+
+        // SplitMix64 finalizer over the running hash and the next value
+        uint64_t combine(uint64_t hash, uint64_t value)
+        {
+            uint64_t z = hash + value + 0x9E3779B97F4A7C15ull;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            return z ^ (z >> 31);
+        }
+
+#ifdef DNA_SIMD_X86
+        inline unsigned count_trailing_zeros(unsigned mask)
+        {
+#ifdef _MSC_VER
+            unsigned long index;
+            _BitScanForward(&index, mask);
+            return index;
+#else
+            return __builtin_ctz(mask);
+#endif
+        }
+
+        // Classify 16 text bytes at once. Returns the number of leading bytes
+        // that are A/C/G/T in either case; codes receives the 2-bit codes of
+        // all 16 bytes, byte i in bits 2i and 2i + 1 (only the leading ones
+        // are meaningful).
+        inline size_t pack_block(const char *text, uint32_t &codes)
+        {
+            __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(text));
+
+            // Clearing bit 5 upper-cases letters and maps nothing else onto A/C/G/T
+            __m128i upper = _mm_and_si128(bytes, _mm_set1_epi8(static_cast<char>(0xDF)));
+            __m128i is_base = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(upper, _mm_set1_epi8('A')),
+                                                        _mm_cmpeq_epi8(upper, _mm_set1_epi8('C'))),
+                                           _mm_or_si128(_mm_cmpeq_epi8(upper, _mm_set1_epi8('G')),
+                                                        _mm_cmpeq_epi8(upper, _mm_set1_epi8('T'))));
+            unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(is_base));
+
+            // ((c >> 1) ^ (c >> 2)) & 3 is 0, 1, 2, 3 for A, C, G, T in either case.
+            // There are no byte shifts, but bits shifted in from the neighboring
+            // byte never reach the two bits that are kept.
+            __m128i code = _mm_and_si128(_mm_xor_si128(_mm_srli_epi16(bytes, 1), _mm_srli_epi16(bytes, 2)),
+                                         _mm_set1_epi8(3));
+
+            // Merge neighbors into 4, 8 and 16 bit groups
+            code = _mm_and_si128(_mm_or_si128(code, _mm_srli_epi16(code, 6)), _mm_set1_epi16(0x000F));
+            code = _mm_and_si128(_mm_or_si128(code, _mm_srli_epi32(code, 12)), _mm_set1_epi32(0x000000FF));
+            code = _mm_or_si128(code, _mm_srli_epi64(code, 24));
+            uint32_t low = static_cast<uint32_t>(_mm_cvtsi128_si32(code)) & 0xFFFF;
+            uint32_t high = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(code, 8))) & 0xFFFF;
+            codes = low | (high << 16);
+
+            return count_trailing_zeros(~mask);
+        }
+#endif
+    }
+
+    void PackedSequence::push_back(char base)
+    {
+        append(&base, 1);
+    }
+
+    size_t PackedSequence::append(const char *bases, size_t count)
+    {
+        size_t start_size = m_size;
+        size_t i = 0;
+
+#ifdef DNA_SIMD_X86
+        while (i + 16 <= count)
+        {
+            uint32_t codes;
+            size_t run = pack_block(bases + i, codes);
+            if (run > 0)
+            {
+                append_codes(run == 16 ? codes : codes & ((1u << (2 * run)) - 1), run);
+                i += run;
+            }
+
+            // Line breaks, N-gaps and other exceptions go through the table
+            // until the next base
+            while (run < 16 && i < count && CODE_TABLE.codes[static_cast<unsigned char>(bases[i])] > 3)
+            {
+                append_byte(bases[i++]);
+            }
+        }
+#endif
+
+        for (; i < count; ++i)
+        {
+            append_byte(bases[i]);
+        }
+
+        return m_size - start_size;
+    }
+
+    void PackedSequence::append_byte(char c)
+    {
+        uint8_t code = CODE_TABLE.codes[static_cast<unsigned char>(c)];
+
+        if (code == SKIP)
+        {
+            return;
+        }
+
+        if ((m_size & 31) == 0)
+        {
+            m_words.push_back(0);
+        }
+
+        if (code == EXCEPTION)
+        {
+            push_exception(static_cast<char>(toupper(static_cast<unsigned char>(c))));
+        }
+        else
+        {
+            m_words.back() |= static_cast<uint64_t>(code) << ((m_size & 31) * 2);
+        }
+
+        m_size++;
+    }
+
+    void PackedSequence::append_codes(uint64_t codes, size_t count)
+    {
+        size_t shift = (m_size & 31) * 2;
+        if (shift == 0)
+        {
+            m_words.push_back(codes);
+        }
+        else
+        {
+            m_words.back() |= codes << shift;
+            if (shift + count * 2 > 64)
+            {
+                m_words.push_back(codes >> (64 - shift));
+            }
+        }
+        m_size += count;
+    }
+
+    void PackedSequence::push_exception(char base)
+    {
+        // Extend the previous run if it is adjacent and holds the same character
+        if (!m_exceptions.empty() && m_exceptions.back().base == base &&
+            m_exceptions.back().start + m_exceptions.back().length == m_size)
+        {
+            m_exceptions.back().length++;
+        }
+        else
+        {
+            m_exceptions.push_back({m_size, 1, base});
+        }
+    }
+
+    size_t PackedSequence::find_exception(size_t pos) const
+    {
+        auto it = upper_bound(m_exceptions.begin(), m_exceptions.end(), pos,
+                              [](size_t p, const ExceptionRun &run)
+                              { return p < run.start + run.length; });
+        return it - m_exceptions.begin();
+    }
+
+    char PackedSequence::at(size_t pos) const
+    {
+        size_t index = find_exception(pos);
+        if (index < m_exceptions.size() && pos >= m_exceptions[index].start)
+        {
+            return m_exceptions[index].base;
+        }
+
+        return BASES[(m_words[pos >> 5] >> ((pos & 31) * 2)) & 3];
+    }
+
+    void PackedSequence::decode(size_t pos, size_t count, char *out) const
+    {
+        // Unpack the 2-bit codes first, then paint the exception runs over them
+        for (size_t i = 0; i < count; ++i)
+        {
+            size_t p = pos + i;
+            out[i] = BASES[(m_words[p >> 5] >> ((p & 31) * 2)) & 3];
+        }
+
+        size_t end = pos + count;
+        for (size_t index = find_exception(pos); index < m_exceptions.size() && m_exceptions[index].start < end; ++index)
+        {
+            const ExceptionRun &run = m_exceptions[index];
+            size_t first = max(run.start, pos);
+            size_t last = min(run.start + run.length, end);
+            fill(out + (first - pos), out + (last - pos), run.base);
+        }
+    }
+
+    string PackedSequence::to_string() const
+    {
+        string result(m_size, 'A');
+        decode(0, m_size, &result[0]);
+        return result;
+    }
+
+    size_t PackedSequence::memory_usage() const
+    {
+        return m_words.capacity() * sizeof(uint64_t) + m_exceptions.capacity() * sizeof(ExceptionRun);
+    }
+
+    uint64_t PackedSequence::checksum() const
+    {
+        // Unused bits of the last word and exception positions are always zero
+        uint64_t hash = combine(0, m_size);
+        for (uint64_t word : m_words)
+        {
+            hash = combine(hash, word);
+        }
+        for (const ExceptionRun &run : m_exceptions)
+        {
+            hash = combine(hash, run.start);
+            hash = combine(hash, run.length);
+            hash = combine(hash, static_cast<unsigned char>(run.base));
+        }
+        return hash;
+    }
+
+} // namespace dna
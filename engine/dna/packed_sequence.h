@@ -0,0 +1,128 @@
+#ifndef PACKED_SEQUENCE_H
+#define PACKED_SEQUENCE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace dna
+{
+
+    // DNA sequence stored at 2 bits per base (32 bases per 64-bit word).
+    // Anything that is not A/C/G/T (N and the other IUPAC codes) is kept in a
+    // separate run-length list of exceptions, since those characters usually
+    // come in long blocks (e.g. N-gaps in assemblies).
+    class PackedSequence
+    {
+    public:
+        PackedSequence() : m_size(0) {}
+        ~PackedSequence() = default;
+
+        // Forward reader over the sequence, used by the linear-scan search algorithms
+        class Cursor
+        {
+        public:
+            Cursor(const PackedSequence &sequence, size_t pos);
+
+            // Current position in the sequence
+            size_t position() const { return m_pos; }
+
+            // Return the base at the current position and advance by one
+            char next()
+            {
+                const std::vector<ExceptionRun> &runs = m_sequence->m_exceptions;
+                if (m_exception < runs.size() && m_pos >= runs[m_exception].start)
+                {
+                    char base = runs[m_exception].base;
+                    if (++m_pos >= runs[m_exception].start + runs[m_exception].length)
+                    {
+                        m_exception++;
+                    }
+                    return base;
+                }
+
+                uint64_t word = m_sequence->m_words[m_pos >> 5];
+                char base = BASES[(word >> ((m_pos & 31) * 2)) & 3];
+                m_pos++;
+                return base;
+            }
+
+        private:
+            const PackedSequence *m_sequence;
+            size_t m_pos;
+            size_t m_exception; // Index of the next exception run at or after m_pos
+        };
+
+        // Remove all bases
+        void clear();
+
+        // Reserve room for a number of bases
+        void reserve(size_t bases);
+
+        // Append a single base (case-insensitive, whitespace is ignored)
+        void push_back(char base);
+
+        // Append a block of raw FASTA text: bases are upper-cased and packed,
+        // whitespace and line breaks are skipped. Runs of A/C/G/T (either case)
+        // are classified and packed 16 bytes at a time with SSE2 on x86-64.
+        // Returns the number of bases added.
+        size_t append(const char *bases, size_t count);
+
+        size_t size() const { return m_size; }
+        bool empty() const { return m_size == 0; }
+
+        // Random access to a single base
+        char at(size_t pos) const;
+
+        // Decode count bases starting at pos into out
+        void decode(size_t pos, size_t count, char *out) const;
+
+        // Decode the whole sequence into a regular string
+        std::string to_string() const;
+
+        // Create a cursor positioned at pos
+        Cursor cursor(size_t pos = 0) const { return Cursor(*this, pos); }
+
+        // Number of non-ACGT runs and the approximate heap footprint in bytes
+        size_t exception_runs() const { return m_exceptions.size(); }
+        size_t memory_usage() const;
+
+        // 64-bit hash of the whole sequence (packed words and exception runs),
+        // used to match saved indexes to the sequence they were built from
+        uint64_t checksum() const;
+
+        // 2-bit code of a base (A=0, C=1, G=2, T=3), or -1 if it is not ACGT
+        static int encode(char base);
+
+    private:
+        // Run of identical non-ACGT characters
+        struct ExceptionRun
+        {
+            size_t start;
+            size_t length;
+            char base;
+        };
+
+        static constexpr char BASES[4] = {'A', 'C', 'G', 'T'};
+
+        std::vector<uint64_t> m_words;
+        std::vector<ExceptionRun> m_exceptions;
+        size_t m_size;
+
+        // Index of the first exception run that ends after pos
+        size_t find_exception(size_t pos) const;
+
+        // Record a non-ACGT character at the end of the sequence
+        void push_exception(char base);
+
+        // Append one raw FASTA byte (base, exception or skipped whitespace)
+        void append_byte(char c);
+
+        // Append count <= 16 bases given as 2-bit codes, first base in the low bits
+        void append_codes(uint64_t codes, size_t count);
+    };
+
+} // namespace dna
+
+#endif // PACKED_SEQUENCE_H
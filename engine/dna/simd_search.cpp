@@ -0,0 +1,205 @@
+#include "simd_search.h"
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define DNA_SIMD_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// GCC and Clang need the AVX2 kernel compiled for that target explicitly;
+// MSVC accepts the intrinsics in any function
+#if defined(DNA_SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+#define DNA_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define DNA_TARGET_AVX2
+#endif
+
+using namespace std;
+
+namespace dna
+{
+    namespace simd
+    {
+
+        namespace
+        {
+            typedef void (*FindAllFunction)(const char *, size_t, const string &, size_t, MatchList &, uint64_t &);
+
+            inline unsigned count_trailing_zeros(unsigned mask)
+            {
+#ifdef _MSC_VER
+                unsigned long index;
+                _BitScanForward(&index, mask);
+                return index;
+#else
+                return __builtin_ctz(mask);
+#endif
+            }
+
+            // Verify a candidate whose first and last bytes already match
+            inline bool verify(const char *candidate, const string &pattern, uint64_t &comparisons)
+            {
+                size_t m = pattern.length();
+                if (m <= 2)
+                {
+                    return true;
+                }
+                comparisons += m - 2;
+                return memcmp(candidate + 1, pattern.data() + 1, m - 2) == 0;
+            }
+
+            // Scalar version of the filter, also used for the tail of the vector kernels
+            void find_all_scalar_from(size_t start, const char *text, size_t length, const string &pattern,
+                                      size_t base_offset, MatchList &matches, uint64_t &comparisons)
+            {
+                size_t m = pattern.length();
+                char first = pattern[0];
+                char last = pattern[m - 1];
+
+                for (size_t i = start; i + m <= length; ++i)
+                {
+                    comparisons++;
+                    if (text[i] == first && text[i + m - 1] == last && verify(text + i, pattern, comparisons))
+                    {
+                        matches.push_back(base_offset + i);
+                    }
+                }
+            }
+
+            void find_all_scalar(const char *text, size_t length, const string &pattern, size_t base_offset,
+                                 MatchList &matches, uint64_t &comparisons)
+            {
+                find_all_scalar_from(0, text, length, pattern, base_offset, matches, comparisons);
+            }
+
+#ifdef DNA_SIMD_X86
+            void find_all_sse2(const char *text, size_t length, const string &pattern, size_t base_offset,
+                               MatchList &matches, uint64_t &comparisons)
+            {
+                size_t m = pattern.length();
+                const __m128i first = _mm_set1_epi8(pattern[0]);
+                const __m128i last = _mm_set1_epi8(pattern[m - 1]);
+
+                size_t i = 0;
+                for (; i + m - 1 + 16 <= length; i += 16)
+                {
+                    __m128i block_first = _mm_loadu_si128(reinterpret_cast<const __m128i *>(text + i));
+                    __m128i block_last = _mm_loadu_si128(reinterpret_cast<const __m128i *>(text + i + m - 1));
+                    unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(
+                        _mm_and_si128(_mm_cmpeq_epi8(first, block_first), _mm_cmpeq_epi8(last, block_last))));
+                    comparisons += 2;
+
+                    while (mask != 0)
+                    {
+                        unsigned bit = count_trailing_zeros(mask);
+                        if (verify(text + i + bit, pattern, comparisons))
+                        {
+                            matches.push_back(base_offset + i + bit);
+                        }
+                        mask &= mask - 1;
+                    }
+                }
+
+                find_all_scalar_from(i, text, length, pattern, base_offset, matches, comparisons);
+            }
+
+            DNA_TARGET_AVX2 void find_all_avx2(const char *text, size_t length, const string &pattern, size_t base_offset,
+                                               MatchList &matches, uint64_t &comparisons)
+            {
+                size_t m = pattern.length();
+                const __m256i first = _mm256_set1_epi8(pattern[0]);
+                const __m256i last = _mm256_set1_epi8(pattern[m - 1]);
+
+                size_t i = 0;
+                for (; i + m - 1 + 32 <= length; i += 32)
+                {
+                    __m256i block_first = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(text + i));
+                    __m256i block_last = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(text + i + m - 1));
+                    unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(
+                        _mm256_and_si256(_mm256_cmpeq_epi8(first, block_first), _mm256_cmpeq_epi8(last, block_last))));
+                    comparisons += 2;
+
+                    while (mask != 0)
+                    {
+                        unsigned bit = count_trailing_zeros(mask);
+                        if (verify(text + i + bit, pattern, comparisons))
+                        {
+                            matches.push_back(base_offset + i + bit);
+                        }
+                        mask &= mask - 1;
+                    }
+                }
+
+                find_all_scalar_from(i, text, length, pattern, base_offset, matches, comparisons);
+            }
+
+            bool cpu_has_avx2()
+            {
+#ifdef _MSC_VER
+                int info[4];
+                __cpuid(info, 0);
+                if (info[0] < 7)
+                {
+                    return false;
+                }
+                __cpuid(info, 1);
+                bool os_saves_ymm = (info[2] & (1 << 27)) && (_xgetbv(0) & 0x6) == 0x6;
+                __cpuidex(info, 7, 0);
+                return os_saves_ymm && (info[1] & (1 << 5));
+#else
+                __builtin_cpu_init();
+                return __builtin_cpu_supports("avx2");
+#endif
+            }
+#endif
+
+            struct Dispatch
+            {
+                FindAllFunction function;
+                const char *name;
+
+                Dispatch() : function(find_all_scalar), name("scalar")
+                {
+#ifdef DNA_SIMD_X86
+                    if (cpu_has_avx2())
+                    {
+                        function = find_all_avx2;
+                        name = "AVX2";
+                    }
+                    else
+                    {
+                        // SSE2 is part of every x86-64 CPU
+                        function = find_all_sse2;
+                        name = "SSE2";
+                    }
+#endif
+                }
+            };
+
+            const Dispatch &dispatch()
+            {
+                static const Dispatch selected;
+                return selected;
+            }
+        }
+
+        const char *backend_name()
+        {
+            return dispatch().name;
+        }
+
+        void find_all(const char *text, size_t length, const string &pattern, size_t base_offset,
+                      MatchList &matches, uint64_t &comparisons)
+        {
+            if (pattern.empty() || length < pattern.length())
+            {
+                return;
+            }
+            dispatch().function(text, length, pattern, base_offset, matches, comparisons);
+        }
+
+    } // namespace simd
+} // namespace dna
@@ -0,0 +1,30 @@
+#ifndef SIMD_SEARCH_H
+#define SIMD_SEARCH_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "match_list.h"
+
+namespace dna
+{
+
+    // Exact matcher using the first/last byte filter: the first and last pattern
+    // bytes are compared against a whole vector of text positions at once and
+    // only positions where both agree are verified with memcmp. The widest
+    // instruction set available at run time is picked (AVX2, SSE2, or scalar).
+    namespace simd
+    {
+        // Name of the implementation chosen by the runtime dispatch
+        const char *backend_name();
+
+        // Add base_offset + p for every match start p in text[0, length).
+        // comparisons counts one per vector (or scalar) compare plus the bytes
+        // handed to memcmp when verifying candidates.
+        void find_all(const char *text, size_t length, const std::string &pattern, size_t base_offset,
+                      MatchList &matches, uint64_t &comparisons);
+    }
+
+} // namespace dna
+
+#endif // SIMD_SEARCH_H
@@ -0,0 +1,267 @@
+#include "grid_history.h"
+#include <algorithm>
+#include <utility>
+
+using namespace std;
+
+namespace evolution
+{
+
+    namespace
+    {
+        void write_varint(vector<uint8_t> &out, size_t value)
+        {
+            while (value >= 0x80)
+            {
+                out.push_back(static_cast<uint8_t>(value | 0x80));
+                value >>= 7;
+            }
+            out.push_back(static_cast<uint8_t>(value));
+        }
+
+        size_t read_varint(const uint8_t *&in)
+        {
+            size_t value = 0;
+            for (int shift = 0;; shift += 7)
+            {
+                uint8_t byte = *in++;
+                value |= static_cast<size_t>(byte & 0x7F) << shift;
+                if (byte < 0x80)
+                {
+                    return value;
+                }
+            }
+        }
+
+        // Appends runs to out while remembering where the last one ended
+        class RunWriter
+        {
+        public:
+            explicit RunWriter(vector<uint8_t> &out) : m_out(out) {}
+
+            void add(size_t first, size_t length, uint8_t state)
+            {
+                write_varint(m_out, first - m_end);
+                m_out.push_back(state);
+                write_varint(m_out, length);
+                m_end = first + length;
+            }
+
+        private:
+            vector<uint8_t> &m_out;
+            size_t m_end = 0;
+        };
+
+        // RunWriter that merges touching runs of the same state and drops
+        // state 0, so pieces added in order come out as maximal runs
+        class RunMerger
+        {
+        public:
+            explicit RunMerger(vector<uint8_t> &out) : m_runs(out) {}
+
+            void add(size_t first, size_t length, uint8_t state)
+            {
+                if (length == 0 || state == 0)
+                {
+                    return;
+                }
+                if (m_length > 0 && m_first + m_length == first && m_state == state)
+                {
+                    m_length += length;
+                    return;
+                }
+                flush();
+                m_first = first;
+                m_length = length;
+                m_state = state;
+            }
+
+            void flush()
+            {
+                if (m_length > 0)
+                {
+                    m_runs.add(m_first, m_length, m_state);
+                    m_length = 0;
+                }
+            }
+
+        private:
+            RunWriter m_runs;
+            size_t m_first = 0;
+            size_t m_length = 0;
+            uint8_t m_state = 0;
+        };
+
+        // Writes the runs of one encoded step into grid
+        void apply_runs(const uint8_t *in, const uint8_t *end, vector<uint8_t> &grid)
+        {
+            size_t cell = 0;
+            while (in < end)
+            {
+                cell += read_varint(in);
+                uint8_t state = *in++;
+                size_t length = read_varint(in);
+                fill_n(grid.begin() + cell, length, state);
+                cell += length;
+            }
+        }
+    }
+
+    void GridHistory::reset(const vector<uint8_t> &grid)
+    {
+        m_cell_count = grid.size();
+        m_deltas.clear();
+        m_delta_offsets.assign(1, 0);
+        m_keyframes.clear();
+        m_keyframe_offsets.assign(1, 0);
+        add_keyframe(grid);
+    }
+
+    void GridHistory::record(const vector<size_t> &changed, const vector<uint8_t> &grid)
+    {
+        // Consecutive changed cells with the same new state form one run
+        RunWriter runs(m_deltas);
+        for (size_t i = 0; i < changed.size();)
+        {
+            size_t first = changed[i];
+            uint8_t state = grid[first];
+            size_t length = 1;
+            while (i + length < changed.size() && changed[i + length] == first + length &&
+                   grid[first + length] == state)
+            {
+                length++;
+            }
+            runs.add(first, length, state);
+            i += length;
+        }
+        m_delta_offsets.push_back(m_deltas.size());
+
+        if ((size() - 1) % KEYFRAME_INTERVAL == 0)
+        {
+            add_keyframe_from_deltas();
+        }
+    }
+
+    size_t GridHistory::memory_bytes() const
+    {
+        return m_deltas.size() + m_keyframes.size() +
+               (m_delta_offsets.size() + m_keyframe_offsets.size()) * sizeof(size_t);
+    }
+
+    void GridHistory::reconstruct(size_t step, vector<uint8_t> &grid) const
+    {
+        size_t keyframe = step / KEYFRAME_INTERVAL;
+        grid.assign(m_cell_count, 0);
+        apply_runs(m_keyframes.data() + m_keyframe_offsets[keyframe],
+                   m_keyframes.data() + m_keyframe_offsets[keyframe + 1], grid);
+
+        for (size_t i = keyframe * KEYFRAME_INTERVAL + 1; i <= step; ++i)
+        {
+            apply_delta(i, grid);
+        }
+    }
+
+    void GridHistory::apply_delta(size_t step, vector<uint8_t> &grid) const
+    {
+        apply_runs(m_deltas.data() + m_delta_offsets[step - 1], m_deltas.data() + m_delta_offsets[step], grid);
+    }
+
+    void GridHistory::add_keyframe_from_deltas()
+    {
+        // Last state of every cell changed since the previous keyframe, by cell
+        size_t last_step = size() - 1;
+        vector<pair<size_t, uint8_t>> changes;
+        for (size_t step = last_step - KEYFRAME_INTERVAL + 1; step <= last_step; ++step)
+        {
+            const uint8_t *in = m_deltas.data() + m_delta_offsets[step - 1];
+            const uint8_t *end = m_deltas.data() + m_delta_offsets[step];
+            size_t cell = 0;
+            while (in < end)
+            {
+                cell += read_varint(in);
+                uint8_t state = *in++;
+                size_t length = read_varint(in);
+                for (size_t i = 0; i < length; ++i)
+                {
+                    changes.emplace_back(cell + i, state);
+                }
+                cell += length;
+            }
+        }
+        stable_sort(changes.begin(), changes.end(), [](const pair<size_t, uint8_t> &a, const pair<size_t, uint8_t> &b)
+                    { return a.first < b.first; });
+
+        // Overlay them on the runs of the previous keyframe: untouched runs are
+        // copied whole, so the cost is that keyframe's runs plus the changes
+        size_t keyframe = last_step / KEYFRAME_INTERVAL - 1;
+        const uint8_t *in = m_keyframes.data() + m_keyframe_offsets[keyframe];
+        const uint8_t *end = m_keyframes.data() + m_keyframe_offsets[keyframe + 1];
+
+        vector<uint8_t> runs;
+        RunMerger merger(runs);
+        size_t c = 0;
+        auto add_change = [&]()
+        {
+            // Only the last change of a cell counts
+            while (c + 1 < changes.size() && changes[c + 1].first == changes[c].first)
+            {
+                c++;
+            }
+            merger.add(changes[c].first, 1, changes[c].second);
+            c++;
+        };
+
+        size_t cell = 0;
+        while (in < end)
+        {
+            cell += read_varint(in);
+            uint8_t state = *in++;
+            size_t length = read_varint(in);
+
+            size_t position = cell;
+            size_t run_end = cell + length;
+            while (c < changes.size() && changes[c].first < run_end)
+            {
+                size_t changed = changes[c].first;
+                if (changed >= position)
+                {
+                    merger.add(position, changed - position, state);
+                    position = changed + 1;
+                }
+                add_change();
+            }
+            merger.add(position, run_end - position, state);
+            cell = run_end;
+        }
+        while (c < changes.size())
+        {
+            add_change();
+        }
+        merger.flush();
+
+        m_keyframes.insert(m_keyframes.end(), runs.begin(), runs.end());
+        m_keyframe_offsets.push_back(m_keyframes.size());
+    }
+
+    void GridHistory::add_keyframe(const vector<uint8_t> &grid)
+    {
+        // The non-zero cells, as runs over an all-zero grid
+        RunWriter runs(m_keyframes);
+        for (size_t cell = 0; cell < grid.size();)
+        {
+            uint8_t state = grid[cell];
+            size_t length = 1;
+            while (cell + length < grid.size() && grid[cell + length] == state)
+            {
+                length++;
+            }
+            if (state != 0)
+            {
+                runs.add(cell, length, state);
+            }
+            cell += length;
+        }
+        m_keyframe_offsets.push_back(m_keyframes.size());
+    }
+
+} // namespace evolution
@@ -0,0 +1,64 @@
+#ifndef GRID_HISTORY_H
+#define GRID_HISTORY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace evolution
+{
+
+    // Compact history of a byte grid. Every step is stored as the list of
+    // cells that changed, run-length encoded: each run of consecutive cells
+    // taking the same new state is a varint gap from the previous run, the
+    // state and a varint length. Every KEYFRAME_INTERVAL steps a keyframe
+    // holds the whole grid in the same form (the runs of non-zero cells), so
+    // any step is rebuilt from the nearest keyframe and at most
+    // KEYFRAME_INTERVAL - 1 deltas. Memory follows the activity of the run,
+    // not steps x cells. Only the first keyframe scans the grid; later ones
+    // are the previous keyframe with the deltas since laid over it, so
+    // recording never costs the grid's area.
+    class GridHistory
+    {
+    public:
+        static const size_t KEYFRAME_INTERVAL = 64;
+
+        // Start a new history whose step 0 is grid
+        void reset(const std::vector<uint8_t> &grid);
+
+        // Append the next step: changed holds the indices of the cells that
+        // differ from the previous step, in increasing order, and grid the
+        // new state of every cell (only read at those indices)
+        void record(const std::vector<size_t> &changed, const std::vector<uint8_t> &grid);
+
+        // Number of recorded steps, including step 0
+        size_t size() const { return m_delta_offsets.size(); }
+
+        // Bytes held by the encoded steps and keyframes
+        size_t memory_bytes() const;
+
+        // Rebuild the grid of any recorded step
+        void reconstruct(size_t step, std::vector<uint8_t> &grid) const;
+
+        // Turn the grid of step - 1 into the grid of step (step >= 1), for
+        // sequential replay
+        void apply_delta(size_t step, std::vector<uint8_t> &grid) const;
+
+    private:
+        size_t m_cell_count = 0;
+
+        // Delta of step i >= 1 in m_deltas[m_delta_offsets[i - 1], m_delta_offsets[i])
+        std::vector<uint8_t> m_deltas;
+        std::vector<size_t> m_delta_offsets;
+
+        // Keyframe k (step k * KEYFRAME_INTERVAL) in the same layout
+        std::vector<uint8_t> m_keyframes;
+        std::vector<size_t> m_keyframe_offsets;
+
+        void add_keyframe(const std::vector<uint8_t> &grid);
+        void add_keyframe_from_deltas();
+    };
+
+} // namespace evolution
+
+#endif // GRID_HISTORY_H
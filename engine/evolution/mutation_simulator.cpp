@@ -1,39 +1,76 @@
 #include "mutation_simulator.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
 #include <iostream>
-#include <unordered_set>
+#include <sstream>
+#include "../utils/thread_pool.h"
 
 using namespace std;
 
 namespace evolution
 {
 
+    namespace
+    {
+        const size_t CANDIDATES_PER_TASK = 4096; // Cells decided per task of a parallel step
+
+        const char CHECKPOINT_MAGIC[8] = {'B', 'S', 'E', 'M', 'U', 'T', 'C', 'P'};
+        const uint32_t CHECKPOINT_VERSION = 1;
+
+        const uint64_t GOLDEN_GAMMA = 0x9E3779B97F4A7C15ull;
+
+        // SplitMix64 output function
+        uint64_t mix64(uint64_t z)
+        {
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            return z ^ (z >> 31);
+        }
+
+        // Value number `counter` of the SplitMix64 stream for seed, in [0, 1).
+        // Any draw can be computed directly, in any order and on any thread.
+        double uniform(uint64_t seed, uint64_t counter)
+        {
+            return (mix64(seed + (counter + 1) * GOLDEN_GAMMA) >> 11) * 0x1.0p-53;
+        }
+    }
+
     MutationSimulator::MutationSimulator(int grid_size, double mutation_prob, double resistance_prob)
+        : MutationSimulator(grid_size, mutation_prob, resistance_prob,
+                            chrono::system_clock::now().time_since_epoch().count())
+    {
+    }
+
+    MutationSimulator::MutationSimulator(int grid_size, double mutation_prob, double resistance_prob, uint64_t seed)
         : m_grid_size(grid_size),
           m_mutation_probability(mutation_prob),
           m_resistance_probability(resistance_prob)
     {
-
-        // random number generator with a time-based seed
-        unsigned seed = chrono::system_clock::now().time_since_epoch().count();
-        m_rng = mt19937(seed);
-        m_dist = uniform_real_distribution<double>(0.0, 1.0);
+        // The initial mutations come from an mt19937 seeded with the same seed
+        m_rng = mt19937(static_cast<uint32_t>(seed ^ (seed >> 32)));
+        m_seed = seed;
 
         // Initializations
-        m_grid = vector<vector<int>>(grid_size, vector<int>(grid_size, NORMAL));
+        size_t cell_count = static_cast<size_t>(grid_size) * grid_size;
+        m_grid.assign(cell_count, NORMAL);
+        m_candidate_bits.assign((cell_count + 63) / 64, 0);
 
         initialize();
     }
 
     void MutationSimulator::initialize(int num_initial_mutations)
     {
-        // Reset grid to all normal cells
-        for (auto &row : m_grid)
+        if (m_grid.empty())
         {
-            fill(row.begin(), row.end(), NORMAL);
+            return;
         }
 
-        // Clear simulation history
-        m_simulation_history.clear();
+        // Reset grid to all normal cells
+        fill(m_grid.begin(), m_grid.end(), NORMAL);
+
+        m_step = 0;
+        m_history_start = 0;
 
         // Add initial mutations at random positions
         uniform_int_distribution<int> pos_dist(0, m_grid_size - 1);
@@ -42,26 +79,34 @@ namespace evolution
         {
             int row = pos_dist(m_rng);
             int col = pos_dist(m_rng);
-            m_grid[row][col] = MUTATED;
+            m_grid[static_cast<size_t>(row) * m_grid_size + col] = MUTATED;
         }
 
         // Store initial state in history
-        m_simulation_history.push_back(m_grid);
+        m_history.reset(m_grid);
+        rebuild_frontier();
 
         cout << "Initialized mutation simulation with grid size " << m_grid_size << "x" << m_grid_size << endl;
         cout << "  - Mutation probability: " << m_mutation_probability << endl;
         cout << "  - Resistance probability: " << m_resistance_probability << endl;
         cout << "  - Initial mutations: " << num_initial_mutations << endl;
+        cout << "  - Seed: " << m_seed << endl;
     }
 
     void MutationSimulator::run_simulation(int steps)
     {
+        if (m_grid.empty())
+        {
+            cerr << "Error: No simulation grid; create one or load a checkpoint first" << endl;
+            return;
+        }
+
         cout << "Running mutation simulation for " << steps << " steps..." << endl;
 
         for (int step = 0; step < steps; ++step)
         {
             simulate_step();
-            m_simulation_history.push_back(m_grid);
+            m_history.record(m_changed, m_grid);
 
             // Print progress every 10 steps
             if ((step + 1) % 10 == 0 || step == steps - 1)
@@ -70,144 +115,290 @@ namespace evolution
             }
         }
 
-        // Count final cell states
-        int normal_count = 0;
-        int mutated_count = 0;
-        int resistant_count = 0;
-
-        for (const auto &row : m_grid)
-        {
-            for (int cell : row)
-            {
-                if (cell == NORMAL)
-                    normal_count++;
-                else if (cell == MUTATED)
-                    mutated_count++;
-                else if (cell == RESISTANT)
-                    resistant_count++;
-            }
-        }
-
         cout << "Simulation complete. Final cell counts:" << endl;
-        cout << "  - Normal cells: " << normal_count << endl;
-        cout << "  - Mutated cells: " << mutated_count << endl;
-        cout << "  - Resistant cells: " << resistant_count << endl;
+        cout << "  - Normal cells: " << m_state_counts[NORMAL] << endl;
+        cout << "  - Mutated cells: " << m_state_counts[MUTATED] << endl;
+        cout << "  - Resistant cells: " << m_state_counts[RESISTANT] << endl;
+        cout << "  - History: " << m_history.size() << " steps in " << m_history.memory_bytes() << " bytes" << endl;
     }
 
     void MutationSimulator::simulate_step()
     {
-        // Create a copy of the current grid
-        auto new_grid = m_grid;
-
-        // Process mutations using BFS-like approach
-        queue<Position> mutation_queue;
-        unordered_set<Position, PositionHash> processed;
-
-        // Find all currently mutated cells
-        for (int i = 0; i < m_grid_size; ++i)
+        // Only a normal cell next to a mutated one can change, and such a
+        // mutated cell is on the frontier. Those candidates are decided in
+        // parallel against the current grid and written back afterwards, so
+        // the result is the same as updating every cell at once. Draws are
+        // keyed by (step, cell), exactly as in a scan of the whole grid.
+        const size_t n = m_grid_size;
+        const uint64_t step_counter = m_step * n * n;
+
+        m_candidates.clear();
+        auto add_candidate = [&](size_t cell)
         {
-            for (int j = 0; j < m_grid_size; ++j)
+            uint64_t bit = uint64_t(1) << (cell & 63);
+            if (m_grid[cell] == NORMAL && !(m_candidate_bits[cell >> 6] & bit))
             {
-                if (m_grid[i][j] == MUTATED)
-                {
-                    mutation_queue.push(Position(i, j));
-                    processed.insert(Position(i, j));
-                }
+                m_candidate_bits[cell >> 6] |= bit;
+                m_candidates.push_back(cell);
             }
-        }
-
-        // Process mutation spread
-        while (!mutation_queue.empty())
+        };
+        for (size_t cell : m_frontier)
         {
-            Position pos = mutation_queue.front();
-            mutation_queue.pop();
-
-            // Get neighbors
-            auto neighbors = get_neighbors(pos.row, pos.col);
+            // 4-directional neighbors (von Neumann neighborhood)
+            size_t col = cell % n;
+            if (cell >= n)
+                add_candidate(cell - n);
+            if (cell + n < n * n)
+                add_candidate(cell + n);
+            if (col > 0)
+                add_candidate(cell - 1);
+            if (col + 1 < n)
+                add_candidate(cell + 1);
+        }
 
-            for (const auto &neighbor : neighbors)
+        m_candidate_states.resize(m_candidates.size());
+        size_t task_count = (m_candidates.size() + CANDIDATES_PER_TASK - 1) / CANDIDATES_PER_TASK;
+        utils::ThreadPool::shared().parallel_for(task_count, [&](size_t task)
+                                                 {
+            size_t end = min(m_candidates.size(), (task + 1) * CANDIDATES_PER_TASK);
+            for (size_t i = task * CANDIDATES_PER_TASK; i < end; ++i)
             {
-                // Skip already processed positions
-                if (processed.find(neighbor) != processed.end())
+                // Two draws per cell and step
+                uint64_t counter = (step_counter + m_candidates[i]) * 2;
+                uint8_t state = NORMAL;
+                if (uniform(m_seed, counter) < m_mutation_probability)
                 {
-                    continue;
+                    state = MUTATED;
                 }
-
-                processed.insert(neighbor);
-
-                // Only normal cells can be mutated or develop resistance
-                if (m_grid[neighbor.row][neighbor.col] == NORMAL)
+                else if (uniform(m_seed, counter + 1) < m_resistance_probability)
                 {
-                    // Check if mutation occurs based on probability
-                    if (m_dist(m_rng) < m_mutation_probability)
-                    {
-                        new_grid[neighbor.row][neighbor.col] = MUTATED;
-                    }
-                    // Check if resistance develops (only if not already mutated)
-                    else if (m_dist(m_rng) < m_resistance_probability)
-                    {
-                        new_grid[neighbor.row][neighbor.col] = RESISTANT;
-                    }
+                    state = RESISTANT;
                 }
+                m_candidate_states[i] = state;
+            } });
+
+        m_changed.clear();
+        for (size_t i = 0; i < m_candidates.size(); ++i)
+        {
+            size_t cell = m_candidates[i];
+            m_candidate_bits[cell >> 6] &= ~(uint64_t(1) << (cell & 63));
+            if (m_candidate_states[i] != NORMAL)
+            {
+                m_grid[cell] = m_candidate_states[i];
+                m_changed.push_back(cell);
+                m_state_counts[NORMAL]--;
+                m_state_counts[m_candidate_states[i]]++;
             }
         }
+        sort(m_changed.begin(), m_changed.end());
 
-        // Update grid
-        m_grid = new_grid;
+        // Mutated cells never change again, so the new frontier is the old one
+        // minus the cells that lost their last normal neighbor, plus the new
+        // mutated cells that still have one
+        size_t kept = 0;
+        for (size_t cell : m_frontier)
+        {
+            if (borders_normal(cell))
+            {
+                m_frontier[kept++] = cell;
+            }
+        }
+        m_frontier.resize(kept);
+        for (size_t cell : m_changed)
+        {
+            if (m_grid[cell] == MUTATED && borders_normal(cell))
+            {
+                m_frontier.push_back(cell);
+            }
+        }
+
+        m_step++;
     }
 
-    bool MutationSimulator::is_valid_position(int row, int col) const
+    bool MutationSimulator::borders_normal(size_t cell) const
     {
-        return row >= 0 && row < m_grid_size && col >= 0 && col < m_grid_size;
+        const size_t n = m_grid_size;
+        size_t col = cell % n;
+        return (cell >= n && m_grid[cell - n] == NORMAL) ||
+               (cell + n < n * n && m_grid[cell + n] == NORMAL) ||
+               (col > 0 && m_grid[cell - 1] == NORMAL) ||
+               (col + 1 < n && m_grid[cell + 1] == NORMAL);
     }
 
-    vector<Position> MutationSimulator::get_neighbors(int row, int col) const
+    void MutationSimulator::rebuild_frontier()
     {
-        vector<Position> neighbors;
-
-        // 4-directional neighbors (von Neumann neighborhood)
-        const int dr[] = {-1, 0, 1, 0};
-        const int dc[] = {0, 1, 0, -1};
-
-        for (int i = 0; i < 4; ++i)
+        m_frontier.clear();
+        fill(begin(m_state_counts), end(m_state_counts), 0);
+        for (size_t cell = 0; cell < m_grid.size(); ++cell)
         {
-            int new_row = row + dr[i];
-            int new_col = col + dc[i];
-
-            if (is_valid_position(new_row, new_col))
+            m_state_counts[m_grid[cell]]++;
+            if (m_grid[cell] == MUTATED && borders_normal(cell))
             {
-                neighbors.emplace_back(new_row, new_col);
+                m_frontier.push_back(cell);
             }
         }
-
-        return neighbors;
     }
 
     bool MutationSimulator::export_results(const string &filename)
     {
+        if (m_grid.empty())
+        {
+            cerr << "Error: No simulation to export" << endl;
+            return false;
+        }
+
         utils::JSONExporter exporter;
 
         // Add simulation parameters
         exporter.add_int("grid_size", m_grid_size);
         exporter.add_double("mutation_probability", m_mutation_probability);
         exporter.add_double("resistance_probability", m_resistance_probability);
-        exporter.add_int("steps", m_simulation_history.size() - 1);
+        exporter.add_string("seed", to_string(m_seed));
+        exporter.add_int("first_step", m_history_start);
+        exporter.add_int("steps", m_history.size() - 1);
 
-        // Add simulation history
+        // Add simulation history, replaying the deltas one step at a time
         exporter.start_array("history");
-        for (size_t step = 0; step < m_simulation_history.size(); ++step)
+        vector<uint8_t> grid;
+        for (size_t step = 0; step < m_history.size(); ++step)
         {
+            if (step == 0)
+            {
+                m_history.reconstruct(0, grid);
+            }
+            else
+            {
+                m_history.apply_delta(step, grid);
+            }
+
             map<string, string> step_obj = {
-                {"step", to_string(step)}};
-            exporter.add_object_to_array(step_obj, step == m_simulation_history.size() - 1);
+                {"step", to_string(m_history_start + step)}};
+            exporter.add_object_to_array(step_obj, step == m_history.size() - 1);
 
             // Add grid for this step
-            exporter.add_grid("grid", m_simulation_history[step]);
+            exporter.add_grid("grid", grid, m_grid_size);
         }
         exporter.end_array();
 
         return exporter.export_to_file(filename);
     }
 
+    bool MutationSimulator::save_checkpoint(const string &filename) const
+    {
+        if (m_grid.empty())
+        {
+            cerr << "Error: No simulation to checkpoint" << endl;
+            return false;
+        }
+
+        ofstream file(filename, ios::binary);
+        if (!file.is_open())
+        {
+            cerr << "Error: Could not open file " << filename << endl;
+            return false;
+        }
+
+        // The mt19937 state has a portable text form
+        ostringstream rng_state;
+        rng_state << m_rng;
+        string rng_text = rng_state.str();
+
+        int64_t grid_size = m_grid_size;
+        uint64_t rng_length = rng_text.size();
+        file.write(CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+        file.write(reinterpret_cast<const char *>(&CHECKPOINT_VERSION), sizeof(CHECKPOINT_VERSION));
+        file.write(reinterpret_cast<const char *>(&grid_size), sizeof(grid_size));
+        file.write(reinterpret_cast<const char *>(&m_mutation_probability), sizeof(m_mutation_probability));
+        file.write(reinterpret_cast<const char *>(&m_resistance_probability), sizeof(m_resistance_probability));
+        file.write(reinterpret_cast<const char *>(&m_seed), sizeof(m_seed));
+        file.write(reinterpret_cast<const char *>(&m_step), sizeof(m_step));
+        file.write(reinterpret_cast<const char *>(&rng_length), sizeof(rng_length));
+        file.write(rng_text.data(), rng_text.size());
+        file.write(reinterpret_cast<const char *>(m_grid.data()), m_grid.size());
+
+        return static_cast<bool>(file);
+    }
+
+    bool MutationSimulator::load_checkpoint(const string &filename)
+    {
+        ifstream file(filename, ios::binary);
+        if (!file.is_open())
+        {
+            cerr << "Error: Could not open file " << filename << endl;
+            return false;
+        }
+
+        file.seekg(0, ios::end);
+        uint64_t file_size = static_cast<uint64_t>(file.tellg());
+        file.seekg(0, ios::beg);
+
+        char magic[sizeof(CHECKPOINT_MAGIC)];
+        uint32_t version = 0;
+        if (!file.read(magic, sizeof(magic)) || memcmp(magic, CHECKPOINT_MAGIC, sizeof(magic)) != 0 ||
+            !file.read(reinterpret_cast<char *>(&version), sizeof(version)) || version != CHECKPOINT_VERSION)
+        {
+            cerr << "Error: " << filename << " is not a supported simulation checkpoint" << endl;
+            return false;
+        }
+
+        int64_t grid_size = 0;
+        double mutation_prob = 0.0, resistance_prob = 0.0;
+        uint64_t seed = 0, step = 0, rng_length = 0;
+        bool valid = file.read(reinterpret_cast<char *>(&grid_size), sizeof(grid_size)) &&
+                     file.read(reinterpret_cast<char *>(&mutation_prob), sizeof(mutation_prob)) &&
+                     file.read(reinterpret_cast<char *>(&resistance_prob), sizeof(resistance_prob)) &&
+                     file.read(reinterpret_cast<char *>(&seed), sizeof(seed)) &&
+                     file.read(reinterpret_cast<char *>(&step), sizeof(step)) &&
+                     file.read(reinterpret_cast<char *>(&rng_length), sizeof(rng_length)) &&
+                     grid_size > 0 && grid_size <= 1 << 20 && rng_length <= 1 << 16;
+
+        // The rest of the file must hold the rng state and the grid, so a
+        // corrupt size is rejected before anything is allocated for it
+        if (valid)
+        {
+            uint64_t position = static_cast<uint64_t>(file.tellg());
+            valid = position <= file_size &&
+                    uint64_t(grid_size) * uint64_t(grid_size) + rng_length <= file_size - position;
+        }
+
+        string rng_text(valid ? rng_length : 0, '\0');
+        vector<uint8_t> grid(valid ? static_cast<size_t>(grid_size * grid_size) : 0);
+        mt19937 rng;
+        valid = valid && file.read(&rng_text[0], rng_text.size()) &&
+                file.read(reinterpret_cast<char *>(grid.data()), grid.size());
+        if (valid)
+        {
+            istringstream rng_state(rng_text);
+            valid = static_cast<bool>(rng_state >> rng);
+        }
+        for (size_t i = 0; valid && i < grid.size(); ++i)
+        {
+            valid = grid[i] <= RESISTANT;
+        }
+
+        if (!valid)
+        {
+            cerr << "Error: Simulation checkpoint " << filename << " is truncated or corrupt" << endl;
+            return false;
+        }
+
+        m_grid_size = static_cast<int>(grid_size);
+        m_mutation_probability = mutation_prob;
+        m_resistance_probability = resistance_prob;
+        m_seed = seed;
+        m_step = step;
+        m_rng = rng;
+        m_grid.swap(grid);
+        m_candidate_bits.assign((m_grid.size() + 63) / 64, 0);
+        rebuild_frontier();
+
+        m_history.reset(m_grid);
+        m_history_start = m_step;
+
+        cout << "Resumed mutation simulation at step " << m_step << " (grid size " << m_grid_size << "x"
+             << m_grid_size << ", seed " << m_seed << ")" << endl;
+        return true;
+    }
+
 } // namespace evolution
 
@@ -1,10 +1,12 @@
 #ifndef MUTATION_SIMULATOR_H
 #define MUTATION_SIMULATOR_H
 
+#include <cstdint>
+#include <string>
 #include <vector>
-#include <queue>
 #include <random>
 #include <chrono>
+#include "grid_history.h"
 #include "../utils/json_exporter.h"
 
 namespace evolution
@@ -18,34 +20,37 @@ namespace evolution
         RESISTANT = 2
     };
 
-    // Position in 2D grid
-    struct Position
+    class MutationSimulator
     {
-        int row;
-        int col;
+    public:
+        // Empty simulator, to be filled by load_checkpoint(); until then it has
+        // no grid to run, export or checkpoint
+        MutationSimulator() = default;
 
-        Position(int r, int c) : row(r), col(c) {}
+        // Seeded from the clock; seed() tells which seed was picked
+        MutationSimulator(int grid_size, double mutation_prob = 0.3, double resistance_prob = 0.1);
 
-        bool operator==(const Position &other) const
-        {
-            return row == other.row && col == other.col;
-        }
-    };
+        // The same seed and parameters always give the same run
+        MutationSimulator(int grid_size, double mutation_prob, double resistance_prob, uint64_t seed);
+        ~MutationSimulator() = default;
 
-    // Custom hash function for Position
-    struct PositionHash
-    {
-        std::size_t operator()(const Position &pos) const
+        uint64_t seed() const { return m_seed; }
+        uint64_t step() const { return m_step; }
+
+        // Change the probabilities for the following steps, e.g. to branch
+        // several parameter sweeps from one checkpointed warm-up
+        void set_probabilities(double mutation_prob, double resistance_prob)
         {
-            return std::hash<int>()(pos.row) ^ (std::hash<int>()(pos.col) << 1);
+            m_mutation_probability = mutation_prob;
+            m_resistance_probability = resistance_prob;
         }
-    };
 
-    class MutationSimulator
-    {
-    public:
-        MutationSimulator(int grid_size, double mutation_prob = 0.3, double resistance_prob = 0.1);
-        ~MutationSimulator() = default;
+        // Binary checkpoint of the parameters, seed, step counter, initial
+        // mutation RNG and current grid. A run resumed from a checkpoint
+        // continues exactly as the original would have; the history restarts
+        // at the checkpointed step.
+        bool save_checkpoint(const std::string &filename) const;
+        bool load_checkpoint(const std::string &filename);
 
         // Initialize the grid with initial mutations
         void initialize(int num_initial_mutations = 1);
@@ -53,31 +58,61 @@ namespace evolution
         // Run the simulation for a specified number of steps
         void run_simulation(int steps);
 
-        // Get the current state of the grid
-        const std::vector<std::vector<int>> &get_grid() const { return m_grid; }
+        // Get the current state of the grid, row-major: cell (row, col) is at
+        // row * grid_size + col
+        const std::vector<uint8_t> &get_grid() const { return m_grid; }
+
+        // Recorded steps; reconstruct(i, grid) gives the grid of step
+        // first_step() + i
+        const GridHistory &get_history() const { return m_history; }
+        uint64_t first_step() const { return m_history_start; }
 
         // Export results to JSON
         bool export_results(const std::string &filename);
 
     private:
-        int m_grid_size;
-        double m_mutation_probability;
-        double m_resistance_probability;
-        std::vector<std::vector<int>> m_grid;
-        std::vector<std::vector<std::vector<int>>> m_simulation_history;
+        int m_grid_size = 0;
+        double m_mutation_probability = 0.0;
+        double m_resistance_probability = 0.0;
+
+        // Current grid, one byte per cell
+        std::vector<uint8_t> m_grid;
+
+        // Active frontier: the mutated cells with a normal neighbor. Only their
+        // normal neighbors can change, so a step costs the outbreak perimeter.
+        std::vector<size_t> m_frontier;
 
-        // Random number generator
+        // Normal cells next to the frontier, deduplicated with a bitmap that is
+        // cleared again at the end of the step, and the state each one takes
+        std::vector<size_t> m_candidates;
+        std::vector<uint64_t> m_candidate_bits;
+        std::vector<uint8_t> m_candidate_states;
+
+        // Cells changed by the last step, in increasing order
+        std::vector<size_t> m_changed;
+
+        // Number of cells in each CellState, kept up to date from m_changed
+        size_t m_state_counts[3] = {0, 0, 0};
+
+        // Every step since initialize() or the checkpoint, as deltas
+        GridHistory m_history;
+
+        // Random number generator for the initial mutations
         std::mt19937 m_rng;
-        std::uniform_real_distribution<double> m_dist;
+
+        // Step draws come from a counter-based stream keyed by m_seed, step and
+        // cell, so the result does not depend on how the grid is split up
+        uint64_t m_seed = 0;
+        uint64_t m_step = 0;          // Steps simulated since initialize()
+        uint64_t m_history_start = 0; // Step of the first grid in the history
 
         // Perform one step of the simulation
         void simulate_step();
 
-        // Check if a position is valid (within grid bounds)
-        bool is_valid_position(int row, int col) const;
+        bool borders_normal(size_t cell) const;
 
-        // Get the neighbors of a cell
-        std::vector<Position> get_neighbors(int row, int col) const;
+        // Find the frontier and the state counts with a scan of the whole grid
+        void rebuild_frontier();
     };
 
 } // namespace evolution
@@ -0,0 +1,374 @@
+#include "centrality.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include "../utils/thread_pool.h"
+
+using namespace std;
+
+namespace graph
+{
+
+    namespace
+    {
+        // Per-thread sums over the sources of one batch
+        struct Accumulators
+        {
+            vector<double> dependency;
+            vector<double> distance_sum;
+            vector<double> reached; // Number of sources that reach the node
+            vector<double> harmonic_sum;
+
+            explicit Accumulators(size_t n)
+                : dependency(n, 0.0), distance_sum(n, 0.0), reached(n, 0.0), harmonic_sum(n, 0.0) {}
+        };
+
+        // Per-thread BFS state, reset through the visit order after every source
+        struct Scratch
+        {
+            vector<int> distance;
+            vector<double> paths; // Number of shortest paths from the source
+            vector<double> delta;
+            vector<int> order;    // Nodes in BFS order (doubles as the queue)
+            vector<size_t> seen;  // Row stamp, to skip parallel edges
+            size_t stamp = 0;
+
+            explicit Scratch(size_t n)
+                : distance(n, -1), paths(n, 0.0), delta(n, 0.0), seen(n, 0) {}
+        };
+
+        const size_t ROW_BLOCK_SIZE = 4096;
+
+        // Run task(begin, end) over blocks of rows on the thread pool and return
+        // the sum of what the blocks report, added up in block order so the
+        // result does not depend on the number of threads
+        template <typename Task>
+        double for_each_row_block(size_t n, const Task &task)
+        {
+            size_t block_count = (n + ROW_BLOCK_SIZE - 1) / ROW_BLOCK_SIZE;
+            vector<double> partial(block_count, 0.0);
+
+            utils::ThreadPool::shared().parallel_for(block_count, [&](size_t block)
+                                                     {
+                size_t begin = block * ROW_BLOCK_SIZE;
+                size_t end = min(n, begin + ROW_BLOCK_SIZE);
+                partial[block] = task(begin, end); });
+
+            double total = 0.0;
+            for (double value : partial)
+            {
+                total += value;
+            }
+            return total;
+        }
+
+        // Starting vector: the previous scores if there are any, else uniform
+        void initial_scores(size_t n, vector<double> &scores)
+        {
+            if (scores.size() != n)
+            {
+                scores.assign(n, 1.0 / n);
+                return;
+            }
+
+            for (double &score : scores)
+            {
+                if (!(score > 0.0))
+                {
+                    score = 1.0 / n;
+                }
+            }
+        }
+
+        void accumulate_source(const vector<size_t> &offsets, const vector<int> &neighbors, int source,
+                               Scratch &scratch, Accumulators &sums)
+        {
+            vector<int> &distance = scratch.distance;
+            vector<double> &paths = scratch.paths;
+            vector<double> &delta = scratch.delta;
+            vector<int> &order = scratch.order;
+
+            order.clear();
+            order.push_back(source);
+            distance[source] = 0;
+            paths[source] = 1.0;
+
+            // Forward BFS counting shortest paths
+            for (size_t head = 0; head < order.size(); ++head)
+            {
+                int v = order[head];
+                scratch.stamp++;
+                for (size_t e = offsets[v]; e < offsets[v + 1]; ++e)
+                {
+                    int w = neighbors[e];
+                    if (scratch.seen[w] == scratch.stamp)
+                    {
+                        continue;
+                    }
+                    scratch.seen[w] = scratch.stamp;
+
+                    if (distance[w] < 0)
+                    {
+                        distance[w] = distance[v] + 1;
+                        order.push_back(w);
+                    }
+                    if (distance[w] == distance[v] + 1)
+                    {
+                        paths[w] += paths[v];
+                    }
+                }
+            }
+
+            // Dependencies in order of decreasing distance; predecessors are the
+            // neighbors one level closer, so no predecessor lists are stored
+            for (size_t i = order.size(); i-- > 1;)
+            {
+                int w = order[i];
+                double share = (1.0 + delta[w]) / paths[w];
+                scratch.stamp++;
+                for (size_t e = offsets[w]; e < offsets[w + 1]; ++e)
+                {
+                    int v = neighbors[e];
+                    if (scratch.seen[v] == scratch.stamp)
+                    {
+                        continue;
+                    }
+                    scratch.seen[v] = scratch.stamp;
+
+                    if (distance[v] == distance[w] - 1)
+                    {
+                        delta[v] += paths[v] * share;
+                    }
+                }
+
+                sums.dependency[w] += delta[w];
+                sums.distance_sum[w] += distance[w];
+                sums.reached[w] += 1.0;
+                sums.harmonic_sum[w] += 1.0 / distance[w];
+            }
+
+            for (int node : order)
+            {
+                distance[node] = -1;
+                paths[node] = 0.0;
+                delta[node] = 0.0;
+            }
+        }
+    }
+
+    void compute_path_centrality(const vector<size_t> &offsets, const vector<int> &neighbors,
+                                 size_t pivots, unsigned seed, PathCentrality &result)
+    {
+        size_t n = offsets.size() - 1;
+        result.betweenness.assign(n, 0.0);
+        result.closeness.assign(n, 0.0);
+        result.harmonic.assign(n, 0.0);
+
+        if (n < 2)
+        {
+            return;
+        }
+
+        // Every node, or a random sample of pivots
+        vector<int> sources(n);
+        for (size_t u = 0; u < n; ++u)
+        {
+            sources[u] = static_cast<int>(u);
+        }
+        if (pivots > 0 && pivots < n)
+        {
+            mt19937 rng(seed);
+            shuffle(sources.begin(), sources.end(), rng);
+            sources.resize(pivots);
+            sort(sources.begin(), sources.end());
+        }
+
+        utils::ThreadPool &pool = utils::ThreadPool::shared();
+        size_t batch_count = min(pool.size(), sources.size());
+        vector<Accumulators> batch_sums(batch_count, Accumulators(n));
+
+        pool.parallel_for(batch_count, [&](size_t batch)
+                          {
+            Scratch scratch(n);
+            for (size_t i = batch; i < sources.size(); i += batch_count)
+            {
+                accumulate_source(offsets, neighbors, sources[i], scratch, batch_sums[batch]);
+            } });
+
+        // Scale sampled sums up to the whole graph. Every pair is seen from both
+        // ends, so betweenness is halved before normalizing by the pair count.
+        double scale = static_cast<double>(n) / sources.size();
+        double pair_count = n > 2 ? (n - 1.0) * (n - 2.0) / 2.0 : 1.0;
+
+        for (size_t u = 0; u < n; ++u)
+        {
+            double dependency = 0.0, distance_sum = 0.0, reached = 0.0, harmonic_sum = 0.0;
+            for (const Accumulators &sums : batch_sums)
+            {
+                dependency += sums.dependency[u];
+                distance_sum += sums.distance_sum[u];
+                reached += sums.reached[u];
+                harmonic_sum += sums.harmonic_sum[u];
+            }
+
+            result.betweenness[u] = dependency * scale / 2.0 / pair_count;
+            result.harmonic[u] = harmonic_sum * scale / (n - 1);
+            if (distance_sum > 0)
+            {
+                // Inverse mean distance to the nodes it reaches, weighted by the share it reaches
+                result.closeness[u] = (reached / distance_sum) * min(1.0, reached * scale / (n - 1));
+            }
+        }
+    }
+
+    PowerIterationResult compute_pagerank(const vector<size_t> &offsets, const vector<int> &neighbors,
+                                          const vector<double> &weights, double damping, double tolerance,
+                                          int max_iterations, vector<double> &scores)
+    {
+        PowerIterationResult result;
+        size_t n = offsets.size() - 1;
+        if (n == 0)
+        {
+            scores.clear();
+            return result;
+        }
+
+        initial_scores(n, scores);
+        double total = for_each_row_block(n, [&](size_t begin, size_t end)
+                                          {
+            double sum = 0.0;
+            for (size_t u = begin; u < end; ++u)
+            {
+                sum += scores[u];
+            }
+            return sum; });
+        for (double &score : scores)
+        {
+            score /= total;
+        }
+
+        // Total outgoing weight of every node (negative weights count as 0)
+        vector<double> strength(n, 0.0);
+        for_each_row_block(n, [&](size_t begin, size_t end)
+                           {
+            for (size_t u = begin; u < end; ++u)
+            {
+                for (size_t e = offsets[u]; e < offsets[u + 1]; ++e)
+                {
+                    strength[u] += max(0.0, weights[e]);
+                }
+            }
+            return 0.0; });
+
+        // The graph is undirected, so each row lists the nodes a node receives
+        // from and the product can be computed row by row without atomics
+        vector<double> share(n), next(n);
+        for (result.iterations = 1; result.iterations <= max_iterations; ++result.iterations)
+        {
+            double dangling = for_each_row_block(n, [&](size_t begin, size_t end)
+                                                 {
+                double lost = 0.0;
+                for (size_t u = begin; u < end; ++u)
+                {
+                    share[u] = strength[u] > 0.0 ? scores[u] / strength[u] : 0.0;
+                    lost += strength[u] > 0.0 ? 0.0 : scores[u];
+                }
+                return lost; });
+
+            double base = (1.0 - damping + damping * dangling) / n;
+            result.change = for_each_row_block(n, [&](size_t begin, size_t end)
+                                               {
+                double change = 0.0;
+                for (size_t v = begin; v < end; ++v)
+                {
+                    double sum = 0.0;
+                    for (size_t e = offsets[v]; e < offsets[v + 1]; ++e)
+                    {
+                        sum += max(0.0, weights[e]) * share[neighbors[e]];
+                    }
+                    next[v] = base + damping * sum;
+                    change += fabs(next[v] - scores[v]);
+                }
+                return change; });
+
+            scores.swap(next);
+            if (result.change < tolerance)
+            {
+                result.converged = true;
+                break;
+            }
+        }
+
+        result.iterations = min(result.iterations, max_iterations);
+        return result;
+    }
+
+    PowerIterationResult compute_eigenvector_centrality(const vector<size_t> &offsets, const vector<int> &neighbors,
+                                                        const vector<double> &weights, double tolerance,
+                                                        int max_iterations, vector<double> &scores)
+    {
+        PowerIterationResult result;
+        size_t n = offsets.size() - 1;
+        if (n == 0)
+        {
+            scores.clear();
+            return result;
+        }
+
+        initial_scores(n, scores);
+        double norm = sqrt(for_each_row_block(n, [&](size_t begin, size_t end)
+                                              {
+            double sum = 0.0;
+            for (size_t u = begin; u < end; ++u)
+            {
+                sum += scores[u] * scores[u];
+            }
+            return sum; }));
+        for (double &score : scores)
+        {
+            score /= norm;
+        }
+
+        vector<double> next(n);
+        for (result.iterations = 1; result.iterations <= max_iterations; ++result.iterations)
+        {
+            // next = (A + I) * scores
+            double squared_norm = for_each_row_block(n, [&](size_t begin, size_t end)
+                                                     {
+                double sum = 0.0;
+                for (size_t v = begin; v < end; ++v)
+                {
+                    double value = scores[v];
+                    for (size_t e = offsets[v]; e < offsets[v + 1]; ++e)
+                    {
+                        value += max(0.0, weights[e]) * scores[neighbors[e]];
+                    }
+                    next[v] = value;
+                    sum += value * value;
+                }
+                return sum; });
+
+            norm = sqrt(squared_norm);
+            result.change = for_each_row_block(n, [&](size_t begin, size_t end)
+                                               {
+                double change = 0.0;
+                for (size_t v = begin; v < end; ++v)
+                {
+                    next[v] /= norm;
+                    change += fabs(next[v] - scores[v]);
+                }
+                return change; });
+
+            scores.swap(next);
+            if (result.change < tolerance)
+            {
+                result.converged = true;
+                break;
+            }
+        }
+
+        result.iterations = min(result.iterations, max_iterations);
+        return result;
+    }
+
+} // namespace graph
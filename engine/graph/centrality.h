@@ -0,0 +1,64 @@
+#ifndef CENTRALITY_H
+#define CENTRALITY_H
+
+#include <cstddef>
+#include <vector>
+
+namespace graph
+{
+
+    // Shortest-path based centrality of every node, all normalized to [0, 1]
+    struct PathCentrality
+    {
+        std::vector<double> betweenness; // Share of shortest paths through the node
+        std::vector<double> closeness;   // Wasserman-Faust closeness (handles disconnected graphs)
+        std::vector<double> harmonic;    // Mean inverse distance to the other nodes
+    };
+
+    // Brandes' algorithm on an undirected, unweighted CSR graph. One BFS per
+    // source computes the betweenness dependencies and, since distances are
+    // symmetric, the closeness sums of every node it reaches. Sources are
+    // split over the shared thread pool with one set of accumulators each.
+    // With pivots > 0 only that many random sources (chosen with seed) are
+    // used and the sums are scaled up, which estimates the exact scores.
+    // Parallel edges are counted once.
+    //
+    // The per-source BFS is deliberately not parallel_bfs: the pool is
+    // already busy with one source per task (a nested parallel_for would run
+    // serially anyway), and Brandes needs shortest-path counts and a
+    // dependency sweep, not just levels. The per-thread queue is also reset
+    // through its visit order, so a source costs what it reaches instead of
+    // parallel_bfs's O(n) setup.
+    void compute_path_centrality(const std::vector<size_t> &offsets, const std::vector<int> &neighbors,
+                                 size_t pivots, unsigned seed, PathCentrality &result);
+
+    // Outcome of a power iteration
+    struct PowerIterationResult
+    {
+        int iterations = 0;
+        double change = 0.0; // L1 change of the last iteration
+        bool converged = false;
+    };
+
+    // Weighted PageRank by power iteration: a node passes its score to its
+    // neighbors in proportion to the edge weights, nodes without positive weight
+    // spread theirs evenly. Stops once the L1 change drops below tolerance.
+    // If scores already holds one value per node it is used as the starting
+    // vector (entries <= 0 start from 1/n), so a rerun after a small change to
+    // the graph only needs a few iterations.
+    PowerIterationResult compute_pagerank(const std::vector<size_t> &offsets, const std::vector<int> &neighbors,
+                                          const std::vector<double> &weights, double damping, double tolerance,
+                                          int max_iterations, std::vector<double> &scores);
+
+    // Weighted eigenvector centrality (principal eigenvector of the adjacency
+    // matrix, unit L2 norm). Iterates with A + I, which has the same eigenvectors
+    // but does not oscillate on bipartite graphs. Same stopping rule and warm
+    // start as compute_pagerank.
+    PowerIterationResult compute_eigenvector_centrality(const std::vector<size_t> &offsets,
+                                                        const std::vector<int> &neighbors,
+                                                        const std::vector<double> &weights, double tolerance,
+                                                        int max_iterations, std::vector<double> &scores);
+
+} // namespace graph
+
+#endif // CENTRALITY_H
@@ -0,0 +1,389 @@
+#include "community.h"
+#include <algorithm>
+#include <atomic>
+#include "../utils/thread_pool.h"
+
+using namespace std;
+
+namespace graph
+{
+
+    namespace
+    {
+        const int MAX_SWEEPS = 32;          // Local move sweeps per level
+        const double MIN_MODULARITY_GAIN = 1e-7;
+
+        // Weighted undirected graph of one Louvain level, in CSR form. A
+        // self-loop entry holds the weight inside a collapsed community.
+        struct LevelGraph
+        {
+            vector<size_t> offsets;
+            vector<int> neighbors;
+            vector<double> weights;
+
+            size_t size() const { return offsets.size() - 1; }
+        };
+
+        // Split [0, n) into one contiguous range per pool thread
+        size_t range_count(size_t n)
+        {
+            return max<size_t>(1, min(utils::ThreadPool::shared().size(), n));
+        }
+
+        template <typename Task>
+        void for_each_range(size_t n, const Task &task)
+        {
+            size_t count = range_count(n);
+            utils::ThreadPool::shared().parallel_for(count, [&](size_t range)
+                                                     { task(n * range / count, n * (range + 1) / count, range); });
+        }
+
+        int find_root(vector<atomic<int>> &parent, int node)
+        {
+            while (true)
+            {
+                int up = parent[node].load(memory_order_relaxed);
+                if (up == node)
+                {
+                    return node;
+                }
+
+                // Path halving; losing the race only means less compression
+                int grand = parent[up].load(memory_order_relaxed);
+                if (grand != up)
+                {
+                    parent[node].compare_exchange_weak(up, grand, memory_order_relaxed);
+                }
+                node = grand;
+            }
+        }
+
+        void unite(vector<atomic<int>> &parent, int a, int b)
+        {
+            while (true)
+            {
+                a = find_root(parent, a);
+                b = find_root(parent, b);
+                if (a == b)
+                {
+                    return;
+                }
+                if (a > b)
+                {
+                    swap(a, b);
+                }
+
+                // Link the larger root under the smaller one, unless another
+                // thread has linked it somewhere in the meantime
+                int expected = b;
+                if (parent[b].compare_exchange_strong(expected, a, memory_order_relaxed))
+                {
+                    return;
+                }
+            }
+        }
+
+        // Relabel to 0, 1, ... in order of first appearance; returns the number of labels
+        int renumber(vector<int> &labels)
+        {
+            vector<int> dense(labels.size(), -1);
+            int count = 0;
+            for (int &label : labels)
+            {
+                if (dense[label] < 0)
+                {
+                    dense[label] = count++;
+                }
+                label = dense[label];
+            }
+            return count;
+        }
+
+        double modularity(const LevelGraph &graph, const vector<int> &community, const vector<double> &total,
+                          double total_weight)
+        {
+            vector<double> partial(range_count(graph.size()), 0.0);
+            for_each_range(graph.size(), [&](size_t begin, size_t end, size_t range)
+                           {
+                for (size_t u = begin; u < end; ++u)
+                {
+                    for (size_t e = graph.offsets[u]; e < graph.offsets[u + 1]; ++e)
+                    {
+                        if (community[graph.neighbors[e]] == community[u])
+                        {
+                            partial[range] += graph.weights[e];
+                        }
+                    }
+                } });
+
+            double internal = 0.0;
+            for (double value : partial)
+            {
+                internal += value;
+            }
+
+            double expected = 0.0;
+            for (double value : total)
+            {
+                expected += (value / total_weight) * (value / total_weight);
+            }
+            return internal / total_weight - expected;
+        }
+
+        // Sweeps of parallel local moves starting from singleton communities.
+        // Returns true if the modularity improved; q receives the modularity.
+        bool move_nodes(const LevelGraph &graph, vector<int> &community, double &q)
+        {
+            size_t n = graph.size();
+
+            // Weighted degree of every node; total_weight is twice the edge weight
+            vector<double> degree(n, 0.0);
+            double total_weight = 0.0;
+            for (size_t u = 0; u < n; ++u)
+            {
+                for (size_t e = graph.offsets[u]; e < graph.offsets[u + 1]; ++e)
+                {
+                    degree[u] += graph.weights[e];
+                }
+                total_weight += degree[u];
+            }
+
+            community.resize(n);
+            for (size_t u = 0; u < n; ++u)
+            {
+                community[u] = static_cast<int>(u);
+            }
+
+            if (total_weight <= 0.0)
+            {
+                q = 0.0;
+                return false;
+            }
+
+            vector<double> total(degree);
+            vector<int> members(n, 1);
+            q = modularity(graph, community, total, total_weight);
+
+            size_t ranges = range_count(n);
+            vector<vector<double>> weight_to(ranges);
+            vector<vector<int>> touched(ranges);
+            vector<int> next(n), previous;
+            bool improved = false;
+
+            for (int sweep = 0; sweep < MAX_SWEEPS; ++sweep)
+            {
+                // Every node picks its best community against the current snapshot
+                for_each_range(n, [&](size_t begin, size_t end, size_t range)
+                               {
+                    vector<double> &weights = weight_to[range];
+                    vector<int> &seen = touched[range];
+                    weights.resize(n, 0.0);
+
+                    for (size_t u = begin; u < end; ++u)
+                    {
+                        int own = community[u];
+                        for (size_t e = graph.offsets[u]; e < graph.offsets[u + 1]; ++e)
+                        {
+                            int v = graph.neighbors[e];
+                            if (v == static_cast<int>(u) || graph.weights[e] <= 0.0)
+                            {
+                                continue;
+                            }
+                            if (weights[community[v]] == 0.0)
+                            {
+                                seen.push_back(community[v]);
+                            }
+                            weights[community[v]] += graph.weights[e];
+                        }
+
+                        // Gain of joining c, up to a common factor: weight to c minus
+                        // the weight expected between u and c in a random graph
+                        double scale = degree[u] / total_weight;
+                        int best = own;
+                        double best_gain = weights[own] - (total[own] - degree[u]) * scale;
+                        for (int c : seen)
+                        {
+                            double gain = weights[c] - total[c] * scale;
+                            if (c != own && (gain > best_gain || (gain == best_gain && best != own && c < best)))
+                            {
+                                best = c;
+                                best_gain = gain;
+                            }
+                        }
+
+                        // Minimum-label rule: two singletons may only merge one way
+                        if (best != own && members[own] == 1 && members[best] == 1 && best > own)
+                        {
+                            best = own;
+                        }
+                        next[u] = best;
+
+                        for (int c : seen)
+                        {
+                            weights[c] = 0.0;
+                        }
+                        seen.clear();
+                    } });
+
+                if (next == community)
+                {
+                    break;
+                }
+
+                previous = community;
+                community = next;
+                fill(total.begin(), total.end(), 0.0);
+                fill(members.begin(), members.end(), 0);
+                for (size_t u = 0; u < n; ++u)
+                {
+                    total[community[u]] += degree[u];
+                    members[community[u]]++;
+                }
+
+                // Simultaneous moves can undo each other; keep a sweep only if it helped
+                double new_q = modularity(graph, community, total, total_weight);
+                if (new_q <= q)
+                {
+                    community = previous;
+                    break;
+                }
+
+                improved = true;
+                bool small_gain = new_q - q < MIN_MODULARITY_GAIN;
+                q = new_q;
+                if (small_gain)
+                {
+                    break;
+                }
+            }
+
+            return improved;
+        }
+
+        // Collapse every community into a single node
+        LevelGraph aggregate(const LevelGraph &graph, const vector<int> &community, int community_count)
+        {
+            size_t n = graph.size();
+
+            // Nodes grouped by community (counting sort)
+            vector<size_t> start(community_count + 1, 0);
+            for (int c : community)
+            {
+                start[c + 1]++;
+            }
+            for (int c = 0; c < community_count; ++c)
+            {
+                start[c + 1] += start[c];
+            }
+            vector<int> by_community(n);
+            vector<size_t> fill_position(start.begin(), start.end() - 1);
+            for (size_t u = 0; u < n; ++u)
+            {
+                by_community[fill_position[community[u]]++] = static_cast<int>(u);
+            }
+
+            LevelGraph coarse;
+            coarse.offsets.push_back(0);
+            vector<double> weight_to(community_count, 0.0);
+            vector<bool> is_touched(community_count, false);
+            vector<int> touched;
+
+            for (int c = 0; c < community_count; ++c)
+            {
+                for (size_t i = start[c]; i < start[c + 1]; ++i)
+                {
+                    int u = by_community[i];
+                    for (size_t e = graph.offsets[u]; e < graph.offsets[u + 1]; ++e)
+                    {
+                        int target = community[graph.neighbors[e]];
+                        if (!is_touched[target])
+                        {
+                            is_touched[target] = true;
+                            touched.push_back(target);
+                        }
+                        weight_to[target] += graph.weights[e];
+                    }
+                }
+
+                for (int target : touched)
+                {
+                    coarse.neighbors.push_back(target);
+                    coarse.weights.push_back(weight_to[target]);
+                    weight_to[target] = 0.0;
+                    is_touched[target] = false;
+                }
+                touched.clear();
+                coarse.offsets.push_back(coarse.neighbors.size());
+            }
+
+            return coarse;
+        }
+    }
+
+    int find_components(size_t node_count, const vector<Edge> &edges, vector<int> &component)
+    {
+        vector<atomic<int>> parent(node_count);
+        for_each_range(node_count, [&](size_t begin, size_t end, size_t)
+                       {
+            for (size_t u = begin; u < end; ++u)
+            {
+                parent[u].store(static_cast<int>(u), memory_order_relaxed);
+            } });
+
+        for_each_range(edges.size(), [&](size_t begin, size_t end, size_t)
+                       {
+            for (size_t e = begin; e < end; ++e)
+            {
+                unite(parent, edges[e].source, edges[e].target);
+            } });
+
+        component.resize(node_count);
+        for_each_range(node_count, [&](size_t begin, size_t end, size_t)
+                       {
+            for (size_t u = begin; u < end; ++u)
+            {
+                component[u] = find_root(parent, static_cast<int>(u));
+            } });
+
+        // Roots are the smallest node of each component, so first appearance
+        // order is the order of the smallest nodes
+        return renumber(component);
+    }
+
+    double detect_communities(const vector<size_t> &offsets, const vector<int> &neighbors,
+                              const vector<double> &weights, vector<int> &community)
+    {
+        LevelGraph graph;
+        graph.offsets = offsets;
+        graph.neighbors = neighbors;
+        graph.weights.resize(weights.size());
+        for (size_t e = 0; e < weights.size(); ++e)
+        {
+            graph.weights[e] = max(0.0, weights[e]);
+        }
+
+        // Community of every original node, as a node of the current level
+        size_t n = graph.size();
+        community.resize(n);
+        for (size_t u = 0; u < n; ++u)
+        {
+            community[u] = static_cast<int>(u);
+        }
+
+        double q = 0.0;
+        vector<int> level_community;
+        while (move_nodes(graph, level_community, q))
+        {
+            int count = renumber(level_community);
+            for (int &c : community)
+            {
+                c = level_community[c];
+            }
+            graph = aggregate(graph, level_community, count);
+        }
+
+        renumber(community);
+        return q;
+    }
+
+} // namespace graph
@@ -0,0 +1,32 @@
+#ifndef COMMUNITY_H
+#define COMMUNITY_H
+
+#include <cstddef>
+#include <vector>
+#include "graph_analyzer.h"
+
+namespace graph
+{
+
+    // Connected components with a lock-free union-find: edges are united in
+    // parallel, each root always being linked under the smaller node ID, so the
+    // final root of a component is its smallest node. Component IDs are dense
+    // and numbered in order of that smallest node. Returns the number of
+    // components. This needs no BFS at all: one pass over the edge list unites
+    // every edge in parallel, where a BFS per component (parallel_bfs
+    // included) would cost O(n) setup for each of possibly many components.
+    int find_components(size_t node_count, const std::vector<Edge> &edges, std::vector<int> &component);
+
+    // Louvain modularity optimization on a weighted undirected CSR graph.
+    // Local moves are decided in parallel against a snapshot of the current
+    // assignment and applied together; a node in a singleton community only
+    // joins another singleton community with a smaller label, so pairs of
+    // nodes cannot keep swapping. Communities are then collapsed into nodes
+    // and the process repeats until nothing moves. Community IDs are dense and
+    // numbered in order of their smallest node. Returns the modularity.
+    double detect_communities(const std::vector<size_t> &offsets, const std::vector<int> &neighbors,
+                              const std::vector<double> &weights, std::vector<int> &community);
+
+} // namespace graph
+
+#endif // COMMUNITY_H
@@ -0,0 +1,316 @@
+#include "edge_list_parser.h"
+#include <charconv>
+#include <cstring>
+#include <string_view>
+#include "../utils/mapped_file.h"
+#include "../utils/thread_pool.h"
+
+using namespace std;
+
+namespace graph
+{
+
+    namespace
+    {
+        enum class LineWarning
+        {
+            InvalidFormat,
+            InvalidWeight
+        };
+
+        const size_t SHARD_COUNT = NodeNameMap::SHARD_COUNT;
+
+        // Everything one thread learns from its slice of the file. Names are
+        // views into the mapping, numbered locally in order of first appearance.
+        struct Chunk
+        {
+            const char *begin = nullptr;
+            const char *end = nullptr;
+            unordered_map<string_view, int> ids;
+            vector<string_view> names;
+            vector<uint8_t> name_shards; // NodeNameMap shard of every local name
+            vector<Edge> edges;
+            vector<pair<size_t, LineWarning>> warnings; // (line within chunk, problem)
+            size_t lines = 0;
+            size_t rows = 0;
+
+            // Local names grouped by shard (in local order within a shard):
+            // shard s holds by_shard[shard_begin[s] .. shard_begin[s + 1])
+            vector<int> by_shard;
+            size_t shard_begin[SHARD_COUNT + 1] = {};
+
+            size_t first_name = 0; // Position of local name 0 among all chunks' names
+            size_t new_names = 0;  // Local names not seen in an earlier chunk
+            vector<int> global_ids;
+        };
+
+        int intern(Chunk &chunk, string_view name)
+        {
+            auto inserted = chunk.ids.emplace(name, static_cast<int>(chunk.names.size()));
+            if (inserted.second)
+            {
+                chunk.names.push_back(name);
+                chunk.name_shards.push_back(static_cast<uint8_t>(NodeNameMap::shard_of(name)));
+            }
+            return inserted.first->second;
+        }
+
+        // Counting sort of the local names by shard
+        void group_by_shard(Chunk &chunk)
+        {
+            for (uint8_t shard : chunk.name_shards)
+            {
+                chunk.shard_begin[shard + 1]++;
+            }
+            for (size_t s = 0; s < SHARD_COUNT; ++s)
+            {
+                chunk.shard_begin[s + 1] += chunk.shard_begin[s];
+            }
+
+            vector<size_t> fill_position(chunk.shard_begin, chunk.shard_begin + SHARD_COUNT);
+            chunk.by_shard.resize(chunk.names.size());
+            for (size_t local = 0; local < chunk.names.size(); ++local)
+            {
+                chunk.by_shard[fill_position[chunk.name_shards[local]]++] = static_cast<int>(local);
+            }
+        }
+
+        // Same rules as stod: leading whitespace and '+' are allowed, trailing text is ignored
+        bool parse_weight(const char *begin, const char *end, double &weight)
+        {
+            while (begin < end && isspace(static_cast<unsigned char>(*begin)))
+            {
+                begin++;
+            }
+            if (begin < end && *begin == '+')
+            {
+                begin++;
+            }
+            return from_chars(begin, end, weight).ec == errc();
+        }
+
+        void parse_line(Chunk &chunk, const char *line, const char *line_end)
+        {
+            chunk.rows++;
+
+            // source,target[,weight[,...]]
+            const char *source_end = static_cast<const char *>(memchr(line, ',', line_end - line));
+            if (source_end == nullptr || source_end + 1 == line_end)
+            {
+                chunk.warnings.emplace_back(chunk.lines, LineWarning::InvalidFormat);
+                return;
+            }
+
+            const char *target = source_end + 1;
+            const char *target_end = static_cast<const char *>(memchr(target, ',', line_end - target));
+            double weight = 1.0;
+
+            if (target_end == nullptr)
+            {
+                target_end = line_end;
+            }
+            else if (target_end + 1 < line_end)
+            {
+                // Optional weight column
+                const char *field = target_end + 1;
+                const char *field_end = static_cast<const char *>(memchr(field, ',', line_end - field));
+                if (!parse_weight(field, field_end == nullptr ? line_end : field_end, weight))
+                {
+                    weight = 1.0;
+                    chunk.warnings.emplace_back(chunk.lines, LineWarning::InvalidWeight);
+                }
+            }
+
+            int source_id = intern(chunk, string_view(line, source_end - line));
+            int target_id = intern(chunk, string_view(target, target_end - target));
+            chunk.edges.emplace_back(source_id, target_id, weight);
+        }
+
+        void parse_chunk(Chunk &chunk, bool first_chunk)
+        {
+            const char *line = chunk.begin;
+            while (line < chunk.end)
+            {
+                const char *line_end = static_cast<const char *>(memchr(line, '\n', chunk.end - line));
+                const char *next_line = line_end == nullptr ? chunk.end : line_end + 1;
+                if (line_end == nullptr)
+                {
+                    line_end = chunk.end;
+                }
+                if (line_end > line && line_end[-1] == '\r')
+                {
+                    line_end--;
+                }
+                chunk.lines++;
+
+                string_view text(line, line_end - line);
+                bool is_header = first_chunk && chunk.lines == 1 &&
+                                 (text.find("source") != string_view::npos || text.find("target") != string_view::npos);
+
+                if (!text.empty() && !is_header)
+                {
+                    parse_line(chunk, line, line_end);
+                }
+                line = next_line;
+            }
+        }
+    }
+
+    bool parse_edge_list(const string &filename, EdgeList &result)
+    {
+        utils::MappedFile file;
+        if (!file.open(filename))
+        {
+            return false;
+        }
+
+        result = EdgeList();
+        const char *data = file.data();
+        const char *end = data + file.size();
+
+        // One chunk per thread, cut at line boundaries, but never so small that
+        // the per-chunk name tables cost more than they save
+        const size_t min_chunk_size = 1 << 20;
+        utils::ThreadPool &pool = utils::ThreadPool::shared();
+        size_t chunk_count = max<size_t>(1, min<size_t>(pool.size(), file.size() / min_chunk_size));
+
+        vector<Chunk> chunks(chunk_count);
+        const char *chunk_begin = data;
+        for (size_t c = 0; c < chunk_count; ++c)
+        {
+            const char *chunk_end = c + 1 == chunk_count ? end : data + file.size() / chunk_count * (c + 1);
+            if (chunk_end < chunk_begin)
+            {
+                chunk_end = chunk_begin;
+            }
+            else if (chunk_end < end)
+            {
+                const char *newline = static_cast<const char *>(memchr(chunk_end, '\n', end - chunk_end));
+                chunk_end = newline == nullptr ? end : newline + 1;
+            }
+
+            chunks[c].begin = chunk_begin;
+            chunks[c].end = chunk_end;
+            chunk_begin = chunk_end;
+        }
+
+        pool.parallel_for(chunk_count, [&](size_t c)
+                          {
+            parse_chunk(chunks[c], c == 0);
+            group_by_shard(chunks[c]); });
+
+        // Every local name gets a position in file order (chunk by chunk)
+        size_t name_count = 0;
+        size_t edge_count = 0;
+        vector<size_t> first_edge(chunk_count);
+        for (size_t c = 0; c < chunk_count; ++c)
+        {
+            chunks[c].first_name = name_count;
+            name_count += chunks[c].names.size();
+            first_edge[c] = edge_count;
+            edge_count += chunks[c].edges.size();
+        }
+
+        // One task per shard: walking the chunks in order, the first position
+        // of every name wins and the later copies point to it
+        vector<unordered_map<string_view, int>> shard_tables(SHARD_COUNT);
+        vector<int> first_position(name_count);
+        pool.parallel_for(SHARD_COUNT, [&](size_t s)
+                          {
+            unordered_map<string_view, int> &table = shard_tables[s];
+            for (const Chunk &chunk : chunks)
+            {
+                for (size_t i = chunk.shard_begin[s]; i < chunk.shard_begin[s + 1]; ++i)
+                {
+                    int local = chunk.by_shard[i];
+                    int position = static_cast<int>(chunk.first_name + local);
+                    first_position[position] = table.emplace(chunk.names[local], position).first->second;
+                }
+            } });
+
+        // Global IDs follow first appearance in the file: count each chunk's
+        // new names, then number them from the chunk's offset
+        pool.parallel_for(chunk_count, [&](size_t c)
+                          {
+            Chunk &chunk = chunks[c];
+            for (size_t local = 0; local < chunk.names.size(); ++local)
+            {
+                size_t position = chunk.first_name + local;
+                chunk.new_names += first_position[position] == static_cast<int>(position);
+            } });
+
+        size_t node_count = 0;
+        vector<size_t> first_id(chunk_count);
+        for (size_t c = 0; c < chunk_count; ++c)
+        {
+            first_id[c] = node_count;
+            node_count += chunks[c].new_names;
+        }
+
+        vector<int> position_ids(name_count, -1);
+        result.node_names.resize(node_count);
+        pool.parallel_for(chunk_count, [&](size_t c)
+                          {
+            Chunk &chunk = chunks[c];
+            int next_id = static_cast<int>(first_id[c]);
+            for (size_t local = 0; local < chunk.names.size(); ++local)
+            {
+                size_t position = chunk.first_name + local;
+                if (first_position[position] == static_cast<int>(position))
+                {
+                    position_ids[position] = next_id;
+                    result.node_names[next_id] = string(chunk.names[local]);
+                    next_id++;
+                }
+            } });
+
+        // Translate the edges, and fill the name map, again in parallel
+        result.edges.assign(edge_count, Edge(0, 0));
+        pool.parallel_for(chunk_count, [&](size_t c)
+                          {
+            Chunk &chunk = chunks[c];
+            chunk.global_ids.resize(chunk.names.size());
+            for (size_t local = 0; local < chunk.names.size(); ++local)
+            {
+                chunk.global_ids[local] = position_ids[first_position[chunk.first_name + local]];
+            }
+
+            Edge *out = result.edges.data() + first_edge[c];
+            for (const Edge &edge : chunk.edges)
+            {
+                *out++ = Edge(chunk.global_ids[edge.source], chunk.global_ids[edge.target], edge.weight);
+            } });
+
+        pool.parallel_for(SHARD_COUNT, [&](size_t s)
+                          {
+            unordered_map<string, int> &table = result.node_ids.shard(s);
+            table.reserve(shard_tables[s].size());
+            for (const auto &[name, position] : shard_tables[s])
+            {
+                table.emplace(string(name), position_ids[position]);
+            } });
+
+        size_t line_offset = 0;
+        for (const Chunk &chunk : chunks)
+        {
+            for (const auto &[line, warning] : chunk.warnings)
+            {
+                size_t line_number = line_offset + line;
+                if (warning == LineWarning::InvalidFormat)
+                {
+                    cerr << "Warning: Invalid format on line " << line_number << ". Expected 'source,target' format." << endl;
+                }
+                else
+                {
+                    cerr << "Warning: Invalid weight value on line " << line_number << ". Using default weight of 1.0." << endl;
+                }
+            }
+
+            line_offset += chunk.lines;
+            result.rows += chunk.rows;
+        }
+
+        return true;
+    }
+
+} // namespace graph
@@ -0,0 +1,33 @@
+#ifndef EDGE_LIST_PARSER_H
+#define EDGE_LIST_PARSER_H
+
+#include <string>
+#include <vector>
+#include "graph_analyzer.h"
+#include "node_name_map.h"
+
+namespace graph
+{
+
+    // Parsed "source,target[,weight]" interaction file. Node IDs are assigned
+    // in order of first appearance, exactly as a line-by-line reader would.
+    struct EdgeList
+    {
+        std::vector<std::string> node_names;
+        NodeNameMap node_ids;
+        std::vector<Edge> edges;
+        size_t rows = 0; // Non-empty data lines, valid or not
+    };
+
+    // Parse an interaction CSV in parallel: the file is memory-mapped and split
+    // on line boundaries, and every chunk is parsed on the shared thread pool
+    // with its own name table. The chunk tables are then interned into the
+    // shards of a NodeNameMap, one task per shard, and IDs are handed out per
+    // chunk in file order, so no step walks all names on a single thread.
+    // Warnings for bad lines are printed with their line numbers. Returns
+    // false if the file cannot be opened.
+    bool parse_edge_list(const std::string &filename, EdgeList &result);
+
+} // namespace graph
+
+#endif // EDGE_LIST_PARSER_H
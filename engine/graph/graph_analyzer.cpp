@@ -1,111 +1,685 @@
 #include "graph_analyzer.h"
 #include <algorithm>
+#include <chrono>
+#include <cmath>
+#include "edge_list_parser.h"
+#include "centrality.h"
+#include "community.h"
+#include "parallel_bfs.h"
+#include "path_finder.h"
+#include "../utils/thread_pool.h"
 
 using namespace std;
 
 namespace graph
 {
 
+    namespace
+    {
+        // Confidences are clamped to [MIN_CONFIDENCE, 1], so every cost is finite and non-negative
+        const double MIN_CONFIDENCE = 1e-9;
+
+        double entry_cost(double weight)
+        {
+            return -log(min(1.0, max(MIN_CONFIDENCE, weight)));
+        }
+
+        // Degree centrality is the degree normalized by n - 1
+        double degree_normalization(size_t node_count)
+        {
+            return node_count > 1 ? 1.0 / (node_count - 1) : 0.0;
+        }
+    }
+
     bool GraphAnalyzer::load_interactions(const string &filename)
     {
-        ifstream file(filename);
+        if (is_snapshot(filename))
+        {
+            return load_snapshot(filename);
+        }
 
-        if (!file.is_open())
+        auto start_time = chrono::high_resolution_clock::now();
+
+        EdgeList edge_list;
+        if (!parse_edge_list(filename, edge_list))
         {
             cerr << "Error: Could not open file " << filename << endl;
             return false;
         }
 
-        m_adjacency_list.clear();
-        m_nodes.clear();
-        m_edges.clear();
+        if (edge_list.node_names.empty())
+        {
+            cerr << "Error: No valid interactions found in file" << endl;
+            return false;
+        }
+
+        // Spectral scores of nodes that are still present seed the next run
+        vector<Node> nodes;
+        nodes.reserve(edge_list.node_names.size());
+        for (const string &name : edge_list.node_names)
+        {
+            nodes.emplace_back(name);
+        }
+        for (const Node &node : m_nodes)
+        {
+            int id = edge_list.node_ids.find(node.id);
+            if (id >= 0)
+            {
+                nodes[id].pagerank = node.pagerank;
+                nodes[id].eigenvector = node.eigenvector;
+            }
+        }
+        m_nodes.swap(nodes);
+        m_node_ids = move(edge_list.node_ids);
+        m_edges = move(edge_list.edges);
+
+        build_csr();
+        reset_rows();
+        m_neighbor_costs.clear();
+        m_path_results.clear();
+        m_bfs_order.clear();
+        m_bfs_levels.clear();
+        m_dfs_order.clear();
+        m_dfs_discovery.clear();
+        m_dfs_finish.clear();
+        m_community_count = 0;
+        m_modularity = 0.0;
+        calculate_degree_centrality();
+        calculate_components();
+
+        double elapsed_ms = chrono::duration<double, milli>(chrono::high_resolution_clock::now() - start_time).count();
+        cout << "Successfully loaded " << m_nodes.size() << " nodes and " << m_edges.size() << " interactions" << endl;
+        cout << "  - Parsed " << edge_list.rows << " rows in " << elapsed_ms << " ms ("
+             << static_cast<long long>(edge_list.rows / max(elapsed_ms / 1000.0, 1e-9)) << " rows/sec)" << endl;
+        return true;
+    }
+
+    int GraphAnalyzer::find_node(const string &name) const
+    {
+        return m_node_ids.find(name);
+    }
+
+    void GraphAnalyzer::build_csr()
+    {
+        size_t n = m_nodes.size();
+
+        // Count the neighbors of every node, then turn the counts into row offsets
+        m_offsets.assign(n + 1, 0);
+        for (const Edge &edge : m_edges)
+        {
+            m_offsets[edge.source + 1]++;
+            m_offsets[edge.target + 1]++; // Undirected graph
+        }
+        for (size_t u = 0; u < n; ++u)
+        {
+            m_offsets[u + 1] += m_offsets[u];
+        }
+
+        // Fill the rows in edge order, so traversals visit neighbors in file order
+        m_neighbors.resize(m_offsets[n]);
+        m_neighbor_weights.resize(m_offsets[n]);
+        m_neighbor_edges.resize(m_offsets[n]);
+        vector<size_t> next(m_offsets.begin(), m_offsets.end() - 1);
+        for (size_t e = 0; e < m_edges.size(); ++e)
+        {
+            const Edge &edge = m_edges[e];
+            m_neighbors[next[edge.source]] = edge.target;
+            m_neighbor_weights[next[edge.source]] = edge.weight;
+            m_neighbor_edges[next[edge.source]++] = static_cast<int>(e);
+            m_neighbors[next[edge.target]] = edge.source;
+            m_neighbor_weights[next[edge.target]] = edge.weight;
+            m_neighbor_edges[next[edge.target]++] = static_cast<int>(e);
+        }
+    }
+
+    void GraphAnalyzer::reset_rows()
+    {
+        size_t n = m_nodes.size();
+        if (m_offsets.empty())
+        {
+            m_offsets.assign(1, 0);
+        }
+        m_row_begin.assign(m_offsets.begin(), m_offsets.end() - 1);
+        m_row_end.assign(m_offsets.begin() + 1, m_offsets.end());
+        m_row_capacity.resize(n);
+        for (size_t u = 0; u < n; ++u)
+        {
+            m_row_capacity[u] = m_row_end[u] - m_row_begin[u];
+        }
+        m_removed_nodes.assign(n, false);
+
+        m_packed = true;
+        m_entry_count = m_neighbors.size();
+        m_removed_edge_count = 0;
+        m_removed_node_count = 0;
+    }
 
-        string line;
-        int line_number = 0;
+    void GraphAnalyzer::begin_update()
+    {
+        // Traversals and path results describe the graph before the update
+        m_packed = false;
+        m_path_results.clear();
+        m_bfs_order.clear();
+        m_bfs_levels.clear();
+        m_dfs_order.clear();
+        m_dfs_discovery.clear();
+        m_dfs_finish.clear();
+    }
 
-        while (getline(file, line))
+    int GraphAnalyzer::intern_node(const string &name)
+    {
+        auto inserted = m_node_ids.emplace(name, static_cast<int>(m_nodes.size()));
+        if (inserted.second)
         {
-            line_number++;
+            m_nodes.emplace_back(name);
+            m_row_begin.push_back(m_neighbors.size());
+            m_row_end.push_back(m_neighbors.size());
+            m_row_capacity.push_back(0);
+            m_removed_nodes.push_back(false);
+
+            m_component_parent.push_back(inserted.first);
+            m_component_count++;
+        }
+        return inserted.first;
+    }
 
-            if (line.empty())
+    void GraphAnalyzer::append_row_entry(int node, int neighbor, double weight, int edge)
+    {
+        // A full row moves to the end of the arrays with twice the room
+        size_t size = m_row_end[node] - m_row_begin[node];
+        if (size == m_row_capacity[node])
+        {
+            size_t capacity = max<size_t>(4, 2 * m_row_capacity[node]);
+            size_t begin = m_neighbors.size();
+            m_neighbors.resize(begin + capacity);
+            m_neighbor_weights.resize(begin + capacity);
+            m_neighbor_edges.resize(begin + capacity);
+            if (!m_neighbor_costs.empty())
             {
-                continue;
+                m_neighbor_costs.resize(begin + capacity);
             }
+            for (size_t i = 0; i < size; ++i)
+            {
+                m_neighbors[begin + i] = m_neighbors[m_row_begin[node] + i];
+                m_neighbor_weights[begin + i] = m_neighbor_weights[m_row_begin[node] + i];
+                m_neighbor_edges[begin + i] = m_neighbor_edges[m_row_begin[node] + i];
+                if (!m_neighbor_costs.empty())
+                {
+                    m_neighbor_costs[begin + i] = m_neighbor_costs[m_row_begin[node] + i];
+                }
+            }
+            m_row_begin[node] = begin;
+            m_row_end[node] = begin + size;
+            m_row_capacity[node] = capacity;
+        }
+
+        size_t slot = m_row_end[node]++;
+        m_neighbors[slot] = neighbor;
+        m_neighbor_weights[slot] = weight;
+        m_neighbor_edges[slot] = edge;
+        if (!m_neighbor_costs.empty())
+        {
+            m_neighbor_costs[slot] = entry_cost(weight);
+        }
+        m_entry_count++;
+
+        Node &row_node = m_nodes[node];
+        row_node.degree++;
+        row_node.centrality = row_node.degree * degree_normalization(m_degree_scale_nodes);
+    }
 
-            if (line_number == 1 && (line.find("source") != string::npos || line.find("target") != string::npos))
+    size_t GraphAnalyzer::remove_row_entries(int node, int neighbor)
+    {
+        size_t begin = m_row_begin[node];
+        size_t kept = 0;
+        for (size_t slot = begin; slot < m_row_end[node]; ++slot)
+        {
+            if (m_neighbors[slot] != neighbor)
             {
-                continue;
+                m_neighbors[begin + kept] = m_neighbors[slot];
+                m_neighbor_weights[begin + kept] = m_neighbor_weights[slot];
+                m_neighbor_edges[begin + kept] = m_neighbor_edges[slot];
+                if (!m_neighbor_costs.empty())
+                {
+                    m_neighbor_costs[begin + kept] = m_neighbor_costs[slot];
+                }
+                kept++;
             }
+        }
+
+        size_t removed = m_row_end[node] - begin - kept;
+        m_row_end[node] = begin + kept;
+        m_entry_count -= removed;
 
-            stringstream ss(line);
-            string source, target;
-            double weight = 1.0;
+        Node &row_node = m_nodes[node];
+        row_node.degree -= static_cast<int>(removed);
+        row_node.centrality = row_node.degree * degree_normalization(m_degree_scale_nodes);
+        return removed;
+    }
+
+    int GraphAnalyzer::component_root(int node)
+    {
+        while (m_component_parent[node] != node)
+        {
+            m_component_parent[node] = m_component_parent[m_component_parent[node]]; // Path halving
+            node = m_component_parent[node];
+        }
+        return node;
+    }
+
+    void GraphAnalyzer::unite_components(int a, int b)
+    {
+        a = component_root(a);
+        b = component_root(b);
+        if (a != b)
+        {
+            m_component_parent[max(a, b)] = min(a, b);
+            m_component_count--;
+        }
+    }
 
-            // Parse CSV format
-            if (getline(ss, source, ',') && getline(ss, target, ','))
+    void GraphAnalyzer::reset_component_forest(const vector<int> &component)
+    {
+        // Labels are numbered in order of their smallest node, which becomes the root
+        vector<int> root;
+        m_component_parent.resize(component.size());
+        for (size_t u = 0; u < component.size(); ++u)
+        {
+            if (component[u] == static_cast<int>(root.size()))
+            {
+                root.push_back(static_cast<int>(u));
+            }
+            m_component_parent[u] = root[component[u]];
+        }
+        m_split_seeds.clear();
+    }
+
+    void GraphAnalyzer::resolve_component_splits()
+    {
+        if (m_split_seeds.empty())
+        {
+            return;
+        }
+
+        // Sets that may have split, each counted once
+        vector<int> roots;
+        for (int seed : m_split_seeds)
+        {
+            roots.push_back(component_root(seed));
+        }
+        sort(roots.begin(), roots.end());
+        roots.erase(unique(roots.begin(), roots.end()), roots.end());
+
+        // Every live node of those sets is in a piece holding a seed. A BFS
+        // from each seed not reached yet collects its piece, whose nodes are
+        // marked with -2 - piece meanwhile (the other sets' parents stay >= 0)
+        vector<int> members;
+        vector<size_t> piece_begin(1, 0);
+        for (int seed : m_split_seeds)
+        {
+            if (m_removed_nodes[seed] || m_component_parent[seed] < 0)
             {
-                // Optional weight column
-                string weight_str;
-                if (getline(ss, weight_str, ','))
+                continue;
+            }
+
+            int mark = -2 - static_cast<int>(piece_begin.size() - 1);
+            m_component_parent[seed] = mark;
+            members.push_back(seed);
+            for (size_t head = piece_begin.back(); head < members.size(); ++head)
+            {
+                int v = members[head];
+                for (size_t e = m_row_begin[v]; e < m_row_end[v]; ++e)
                 {
-                    try
+                    int w = m_neighbors[e];
+                    if (m_component_parent[w] >= 0)
                     {
-                        weight = stod(weight_str);
-                    }
-                    catch (const exception &e)
-                    {
-                        cerr << "Warning: Invalid weight value on line " << line_number << ". Using default weight of 1.0." << endl;
+                        m_component_parent[w] = mark;
+                        members.push_back(w);
                     }
                 }
+            }
+            piece_begin.push_back(members.size());
+        }
+
+        // Each piece becomes a set rooted at its smallest node
+        size_t piece_count = piece_begin.size() - 1;
+        for (size_t p = 0; p < piece_count; ++p)
+        {
+            int root = *min_element(members.begin() + piece_begin[p], members.begin() + piece_begin[p + 1]);
+            for (size_t i = piece_begin[p]; i < piece_begin[p + 1]; ++i)
+            {
+                m_component_parent[members[i]] = root;
+            }
+        }
+
+        m_component_count += static_cast<int>(piece_count) - static_cast<int>(roots.size());
+        m_split_seeds.clear();
+    }
+
+    void GraphAnalyzer::label_components()
+    {
+        // Roots are the smallest nodes, so this matches find_components
+        vector<int> label(m_nodes.size(), -1);
+        int count = 0;
+        for (size_t u = 0; u < m_nodes.size(); ++u)
+        {
+            if (m_removed_nodes[u])
+            {
+                continue;
+            }
+            int root = component_root(static_cast<int>(u));
+            if (label[root] < 0)
+            {
+                label[root] = count++;
+            }
+            m_nodes[u].component = label[root];
+        }
+    }
 
-                // Add edge to the graph
-                m_adjacency_list[source].push_back(target);
-                m_adjacency_list[target].push_back(source); // Undirected graph
+    void GraphAnalyzer::refresh_degree_centrality()
+    {
+        size_t node_count = m_nodes.size() - m_removed_node_count;
+        if (node_count == m_degree_scale_nodes)
+        {
+            return;
+        }
 
-                // Add nodes if they don't exist
-                if (m_nodes.find(source) == m_nodes.end())
+        m_degree_scale_nodes = node_count;
+        double normalization_factor = degree_normalization(node_count);
+        for (Node &node : m_nodes)
+        {
+            node.centrality = node.degree * normalization_factor;
+        }
+    }
+
+    bool GraphAnalyzer::add_node(const string &name)
+    {
+        if (name.empty() || find_node(name) >= 0)
+        {
+            return false;
+        }
+
+        begin_update();
+        intern_node(name);
+        return true;
+    }
+
+    bool GraphAnalyzer::remove_node(const string &name)
+    {
+        int node = find_node(name);
+        if (node < 0)
+        {
+            return false;
+        }
+
+        begin_update();
+
+        // Tombstone its edges and drop it from the rows of its neighbors, each
+        // of which may now lie in a different component
+        for (size_t slot = m_row_begin[node]; slot < m_row_end[node]; ++slot)
+        {
+            Edge &edge = m_edges[m_neighbor_edges[slot]];
+            if (edge.source < 0)
+            {
+                continue; // A parallel edge already handled
+            }
+            edge.source = edge.target = -1;
+            m_removed_edge_count++;
+
+            int neighbor = m_neighbors[slot];
+            if (neighbor != node)
+            {
+                remove_row_entries(neighbor, node);
+                m_split_seeds.push_back(neighbor);
+            }
+        }
+        m_split_seeds.push_back(node);
+
+        m_entry_count -= m_row_end[node] - m_row_begin[node];
+        m_row_end[node] = m_row_begin[node];
+        m_nodes[node].degree = 0;
+        m_nodes[node].centrality = 0.0;
+        m_removed_nodes[node] = true;
+        m_removed_node_count++;
+        m_node_ids.erase(name);
+
+        compact_if_sparse();
+        return true;
+    }
+
+    size_t GraphAnalyzer::add_interactions(const vector<Interaction> &interactions)
+    {
+        begin_update();
+
+        size_t added = 0;
+        for (const Interaction &interaction : interactions)
+        {
+            if (interaction.source.empty() || interaction.target.empty())
+            {
+                cerr << "Warning: Skipping interaction with an empty node name" << endl;
+                continue;
+            }
+
+            int source = intern_node(interaction.source);
+            int target = intern_node(interaction.target);
+            int edge = static_cast<int>(m_edges.size());
+            m_edges.emplace_back(source, target, interaction.weight);
+
+            // Same entries as build_csr: one per direction, two for a self-loop
+            append_row_entry(source, target, interaction.weight, edge);
+            append_row_entry(target, source, interaction.weight, edge);
+
+            unite_components(source, target);
+            added++;
+        }
+
+        compact_if_sparse();
+        return added;
+    }
+
+    size_t GraphAnalyzer::remove_interactions(const vector<pair<string, string>> &pairs)
+    {
+        begin_update();
+
+        size_t removed = 0;
+        for (const auto &node_pair : pairs)
+        {
+            int a = find_node(node_pair.first);
+            int b = find_node(node_pair.second);
+            if (a < 0 || b < 0)
+            {
+                continue;
+            }
+
+            for (size_t slot = m_row_begin[a]; slot < m_row_end[a]; ++slot)
+            {
+                Edge &edge = m_edges[m_neighbor_edges[slot]];
+                if (m_neighbors[slot] == b && edge.source >= 0)
                 {
-                    m_nodes[source] = Node(source);
+                    edge.source = edge.target = -1;
+                    m_removed_edge_count++;
+                    removed++;
                 }
-                if (m_nodes.find(target) == m_nodes.end())
+            }
+
+            if (remove_row_entries(a, b) > 0 && a != b)
+            {
+                remove_row_entries(b, a);
+                m_split_seeds.push_back(a);
+                m_split_seeds.push_back(b);
+            }
+        }
+
+        compact_if_sparse();
+        return removed;
+    }
+
+    void GraphAnalyzer::compact_if_sparse()
+    {
+        size_t garbage = (m_neighbors.size() - m_entry_count) + m_removed_edge_count + m_removed_node_count;
+        size_t live = m_entry_count + (m_edges.size() - m_removed_edge_count) + (m_nodes.size() - m_removed_node_count);
+        if (garbage > live)
+        {
+            compact_updates();
+        }
+    }
+
+    void GraphAnalyzer::compact_updates()
+    {
+        if (m_packed)
+        {
+            return;
+        }
+
+        // The union-find must not lead through removed nodes
+        resolve_component_splits();
+
+        // Dense IDs for the nodes that are left, in their old order
+        size_t n = m_nodes.size();
+        vector<int> new_id(n, -1);
+        int node_count = 0;
+        for (size_t u = 0; u < n; ++u)
+        {
+            if (!m_removed_nodes[u])
+            {
+                new_id[u] = node_count++;
+            }
+        }
+
+        // Edges that are left, in order
+        vector<int> new_edge(m_edges.size(), -1);
+        size_t edge_count = 0;
+        for (size_t e = 0; e < m_edges.size(); ++e)
+        {
+            const Edge &edge = m_edges[e];
+            if (edge.source >= 0)
+            {
+                new_edge[e] = static_cast<int>(edge_count);
+                m_edges[edge_count++] = Edge(new_id[edge.source], new_id[edge.target], edge.weight);
+            }
+        }
+        m_edges.erase(m_edges.begin() + edge_count, m_edges.end());
+
+        // Pack the rows in node order; they already list neighbors in edge order
+        vector<size_t> offsets(node_count + 1, 0);
+        for (size_t u = 0; u < n; ++u)
+        {
+            if (new_id[u] >= 0)
+            {
+                offsets[new_id[u] + 1] = m_row_end[u] - m_row_begin[u];
+            }
+        }
+        for (int u = 0; u < node_count; ++u)
+        {
+            offsets[u + 1] += offsets[u];
+        }
+
+        bool has_costs = !m_neighbor_costs.empty();
+        vector<int> neighbors(offsets[node_count]), neighbor_edges(offsets[node_count]);
+        vector<double> weights(offsets[node_count]), costs(has_costs ? offsets[node_count] : 0);
+        for (size_t u = 0; u < n; ++u)
+        {
+            if (new_id[u] < 0)
+            {
+                continue;
+            }
+            size_t slot = offsets[new_id[u]];
+            for (size_t i = m_row_begin[u]; i < m_row_end[u]; ++i, ++slot)
+            {
+                neighbors[slot] = new_id[m_neighbors[i]];
+                weights[slot] = m_neighbor_weights[i];
+                neighbor_edges[slot] = new_edge[m_neighbor_edges[i]];
+                if (has_costs)
                 {
-                    m_nodes[target] = Node(target);
+                    costs[slot] = m_neighbor_costs[i];
                 }
+            }
+        }
+        m_offsets.swap(offsets);
+        m_neighbors.swap(neighbors);
+        m_neighbor_weights.swap(weights);
+        m_neighbor_edges.swap(neighbor_edges);
+        m_neighbor_costs.swap(costs);
 
-                // Add edge
-                m_edges.emplace_back(source, target, weight);
+        // Carry over the union-find; removed nodes are never the root of a survivor
+        vector<int> component_parent(node_count);
+        for (size_t u = 0; u < n; ++u)
+        {
+            if (new_id[u] >= 0)
+            {
+                component_parent[new_id[u]] = new_id[component_root(static_cast<int>(u))];
             }
-            else
+        }
+        m_component_parent.swap(component_parent);
+
+        for (size_t u = 0; u < n; ++u)
+        {
+            if (new_id[u] >= 0 && new_id[u] != static_cast<int>(u))
             {
-                cerr << "Warning: Invalid format on line " << line_number << ". Expected 'source,target' format." << endl;
+                m_nodes[new_id[u]] = move(m_nodes[u]);
+                m_node_ids.assign(m_nodes[new_id[u]].id, new_id[u]);
             }
         }
+        m_nodes.resize(node_count);
 
-        file.close();
+        reset_rows();
+        refresh_degree_centrality();
+        label_components();
+    }
 
-        if (m_nodes.empty())
+    void GraphAnalyzer::calculate_components()
+    {
+        vector<int> component;
+        m_component_count = find_components(m_nodes.size(), m_edges, component);
+        reset_component_forest(component);
+        for (size_t u = 0; u < m_nodes.size(); ++u)
         {
-            cerr << "Error: No valid interactions found in file" << endl;
-            return false;
+            m_nodes[u].component = component[u];
         }
+    }
 
-        cout << "Successfully loaded " << m_nodes.size() << " nodes and " << m_edges.size() << " interactions" << endl;
-        return true;
+    vector<string> GraphAnalyzer::node_names(const vector<int> &ids) const
+    {
+        vector<string> names;
+        names.reserve(ids.size());
+        for (int id : ids)
+        {
+            names.push_back(m_nodes[id].id);
+        }
+        return names;
     }
 
     void GraphAnalyzer::analyze(const string &start_node)
     {
+        compact_updates();
+        if (m_nodes.empty())
+        {
+            cerr << "Error: No interactions to analyze" << endl;
+            return;
+        }
+
         // Calculate degree centrality
         calculate_degree_centrality();
 
+        // Calculate betweenness, closeness and harmonic centrality
+        calculate_path_centrality();
+
+        // Calculate PageRank and eigenvector centrality
+        calculate_spectral_centrality();
+
+        // Find components and communities
+        calculate_communities();
+
         // Perform BFS traversal
-        if (!start_node.empty() && m_nodes.find(start_node) != m_nodes.end())
+        int start = find_node(start_node);
+        if (!start_node.empty() && start >= 0)
         {
-            m_bfs_order = bfs_traversal(start_node);
-            m_dfs_order = dfs_traversal(start_node);
+            m_bfs_order = bfs_traversal(start);
+            m_dfs_order = dfs_traversal(start);
 
             cout << "Graph analysis complete:" << endl;
-            cout << "  - BFS traversal from " << start_node << " visited " << m_bfs_order.size() << " nodes" << endl;
+            cout << "  - BFS traversal from " << start_node << " visited " << m_bfs_order.size() << " nodes ("
+                 << m_bfs_levels[m_bfs_order.back()] + 1 << " levels)" << endl;
             cout << "  - DFS traversal from " << start_node << " visited " << m_dfs_order.size() << " nodes" << endl;
         }
         else
@@ -117,177 +691,414 @@ namespace graph
     void GraphAnalyzer::calculate_degree_centrality()
     {
         // Calculate degree for each node
-        for (auto &[node_id, node] : m_nodes)
+        for (size_t u = 0; u < m_nodes.size(); ++u)
         {
-            node.degree = m_adjacency_list[node_id].size();
+            m_nodes[u].degree = static_cast<int>(m_offsets[u + 1] - m_offsets[u]);
         }
 
         // Calculate degree centrality (normalized by n-1 where n is the number of nodes)
-        int n = m_nodes.size();
-        if (n > 1)
+        m_degree_scale_nodes = m_nodes.size();
+        double normalization_factor = degree_normalization(m_degree_scale_nodes);
+        for (Node &node : m_nodes)
         {
-            double normalization_factor = 1.0 / (n - 1);
-            for (auto &[node_id, node] : m_nodes)
-            {
-                node.centrality = node.degree * normalization_factor;
-            }
+            node.centrality = node.degree * normalization_factor;
         }
     }
 
-    vector<string> GraphAnalyzer::bfs_traversal(const string &start_node)
+    void GraphAnalyzer::calculate_path_centrality()
     {
-        vector<string> result;
-        unordered_set<string> visited;
-        queue<string> queue;
+        auto start_time = chrono::high_resolution_clock::now();
 
-        // Start BFS from the given node
-        queue.push(start_node);
-        visited.insert(start_node);
+        PathCentrality scores;
+        compute_path_centrality(m_offsets, m_neighbors, m_centrality_pivots, m_centrality_seed, scores);
 
-        while (!queue.empty())
+        for (size_t u = 0; u < m_nodes.size(); ++u)
         {
-            string current = queue.front();
-            queue.pop();
-            result.push_back(current);
+            m_nodes[u].betweenness = scores.betweenness[u];
+            m_nodes[u].closeness = scores.closeness[u];
+            m_nodes[u].harmonic = scores.harmonic[u];
+        }
 
-            // Visit all adjacent nodes
-            for (const string &neighbor : m_adjacency_list[current])
+        double elapsed_ms = chrono::duration<double, milli>(chrono::high_resolution_clock::now() - start_time).count();
+        cout << "Betweenness and closeness centrality computed in " << elapsed_ms << " ms";
+        if (m_centrality_pivots > 0 && m_centrality_pivots < m_nodes.size())
+        {
+            cout << " (estimated from " << m_centrality_pivots << " pivots)";
+        }
+        cout << endl;
+    }
+
+    void GraphAnalyzer::calculate_spectral_centrality()
+    {
+        const double damping = 0.85;
+        const double tolerance = 1e-6;
+        const int max_iterations = 100;
+
+        vector<double> pagerank, eigenvector;
+        bool warm_start = false;
+        for (const Node &node : m_nodes)
+        {
+            warm_start = warm_start || node.pagerank > 0.0;
+        }
+        if (warm_start)
+        {
+            for (const Node &node : m_nodes)
             {
-                if (visited.find(neighbor) == visited.end())
-                {
-                    visited.insert(neighbor);
-                    queue.push(neighbor);
-                }
+                pagerank.push_back(node.pagerank);
+                eigenvector.push_back(node.eigenvector);
             }
         }
 
-        return result;
+        auto start_time = chrono::high_resolution_clock::now();
+        PowerIterationResult pagerank_run = compute_pagerank(m_offsets, m_neighbors, m_neighbor_weights, damping,
+                                                             tolerance, max_iterations, pagerank);
+        PowerIterationResult eigenvector_run = compute_eigenvector_centrality(m_offsets, m_neighbors, m_neighbor_weights,
+                                                                             tolerance, max_iterations, eigenvector);
+        double elapsed_ms = chrono::duration<double, milli>(chrono::high_resolution_clock::now() - start_time).count();
+
+        for (size_t u = 0; u < m_nodes.size(); ++u)
+        {
+            m_nodes[u].pagerank = pagerank[u];
+            m_nodes[u].eigenvector = eigenvector[u];
+        }
+
+        cout << "PageRank and eigenvector centrality computed in " << elapsed_ms << " ms"
+             << (warm_start ? " (warm start)" : "") << ":" << endl;
+        cout << "  - PageRank: " << pagerank_run.iterations << " iterations"
+             << (pagerank_run.converged ? "" : " (not converged)") << endl;
+        cout << "  - Eigenvector: " << eigenvector_run.iterations << " iterations"
+             << (eigenvector_run.converged ? "" : " (not converged)") << endl;
     }
 
-    vector<string> GraphAnalyzer::dfs_traversal(const string &start_node)
+    void GraphAnalyzer::calculate_communities()
     {
-        vector<string> result;
-        unordered_set<string> visited;
+        auto start_time = chrono::high_resolution_clock::now();
 
-        dfs_helper(start_node, visited, result);
+        // Components are already labeled, and kept current by the live updates
+        vector<int> community;
+        m_modularity = detect_communities(m_offsets, m_neighbors, m_neighbor_weights, community);
 
-        return result;
+        vector<size_t> component_sizes(m_component_count, 0);
+        m_community_count = 0;
+        for (size_t u = 0; u < m_nodes.size(); ++u)
+        {
+            m_nodes[u].community = community[u];
+            component_sizes[m_nodes[u].component]++;
+            m_community_count = max(m_community_count, community[u] + 1);
+        }
+
+        double elapsed_ms = chrono::duration<double, milli>(chrono::high_resolution_clock::now() - start_time).count();
+        cout << "Network structure computed in " << elapsed_ms << " ms:" << endl;
+        cout << "  - Connected components: " << m_component_count << " (largest has "
+             << *max_element(component_sizes.begin(), component_sizes.end()) << " nodes)" << endl;
+        cout << "  - Communities: " << m_community_count << " (modularity " << m_modularity << ")" << endl;
+    }
+
+    vector<int> GraphAnalyzer::bfs_traversal(int start_node)
+    {
+        BFSResult bfs;
+        parallel_bfs(m_offsets, m_neighbors, start_node, true, bfs);
+        m_bfs_levels.swap(bfs.level);
+        return bfs.order;
     }
 
-    void GraphAnalyzer::dfs_helper(const string &node, unordered_set<string> &visited, vector<string> &result)
+    vector<int> GraphAnalyzer::dfs_traversal(int start_node)
     {
-        visited.insert(node);
-        result.push_back(node);
+        vector<int> result;
+        vector<bool> visited(m_nodes.size(), false);
+        m_dfs_discovery.assign(m_nodes.size(), -1);
+        m_dfs_finish.assign(m_nodes.size(), -1);
+        int clock = 0;
 
-        // Visit all adjacent nodes
-        for (const string &neighbor : m_adjacency_list[node])
+        // Explicit stack of (node, next edge to try), so deep graphs cannot
+        // overflow the call stack. Neighbors are tried in adjacency order,
+        // which gives the same visitation order as the recursive version.
+        vector<pair<int, size_t>> stack;
+        visited[start_node] = true;
+        m_dfs_discovery[start_node] = clock++;
+        result.push_back(start_node);
+        stack.emplace_back(start_node, m_offsets[start_node]);
+
+        while (!stack.empty())
         {
-            if (visited.find(neighbor) == visited.end())
+            int node = stack.back().first;
+            size_t &next_edge = stack.back().second;
+
+            // Skip neighbors that were reached in the meantime
+            while (next_edge < m_offsets[node + 1] && visited[m_neighbors[next_edge]])
+            {
+                next_edge++;
+            }
+
+            if (next_edge == m_offsets[node + 1])
             {
-                dfs_helper(neighbor, visited, result);
+                m_dfs_finish[node] = clock++;
+                stack.pop_back();
+                continue;
             }
+
+            int neighbor = m_neighbors[next_edge++];
+            visited[neighbor] = true;
+            m_dfs_discovery[neighbor] = clock++;
+            result.push_back(neighbor);
+            stack.emplace_back(neighbor, m_offsets[neighbor]);
+        }
+
+        return result;
+    }
+
+    const vector<double> &GraphAnalyzer::path_costs()
+    {
+        if (m_neighbor_costs.size() == m_neighbor_weights.size())
+        {
+            return m_neighbor_costs;
         }
+
+        m_neighbor_costs.resize(m_neighbor_weights.size());
+
+        const size_t block_size = 1 << 16;
+        size_t block_count = (m_neighbor_weights.size() + block_size - 1) / block_size;
+        utils::ThreadPool::shared().parallel_for(block_count, [&](size_t block)
+                                                 {
+            size_t end = min(m_neighbor_weights.size(), (block + 1) * block_size);
+            for (size_t e = block * block_size; e < end; ++e)
+            {
+                m_neighbor_costs[e] = entry_cost(m_neighbor_weights[e]);
+            } });
+
+        return m_neighbor_costs;
     }
 
-    vector<string> GraphAnalyzer::shortest_path(const string &source, const string &target)
+    PathResult GraphAnalyzer::find_path(const string &source, const string &target)
     {
-        vector<string> path;
+        PathResult result;
+        result.source = source;
+        result.target = target;
 
-        // Check if source and target exist
-        if (m_nodes.find(source) == m_nodes.end() || m_nodes.find(target) == m_nodes.end())
+        int source_id = find_node(source);
+        int target_id = find_node(target);
+        if (source_id < 0 || target_id < 0)
         {
-            return path;
+            return result;
         }
 
-        // BFS to find shortest path
-        unordered_map<string, string> prev;
-        unordered_set<string> visited;
-        queue<string> queue;
+        PathFinder finder(m_row_begin, m_row_end, m_neighbors, path_costs());
+        vector<int> path;
+        if (finder.find_path(source_id, target_id, path, result.cost))
+        {
+            result.path = node_names(path);
+        }
+        return result;
+    }
+
+    const vector<PathResult> &GraphAnalyzer::find_paths(const vector<pair<string, string>> &queries)
+    {
+        auto start_time = chrono::high_resolution_clock::now();
+        const vector<double> &costs = path_costs();
 
-        queue.push(source);
-        visited.insert(source);
+        m_path_results.assign(queries.size(), PathResult());
 
-        bool found = false;
-        while (!queue.empty() && !found)
+        // Group the queries by source, in order of first appearance
+        unordered_map<int, size_t> group_of_source;
+        vector<int> group_sources;
+        vector<vector<size_t>> group_queries;
+        for (size_t q = 0; q < queries.size(); ++q)
         {
-            string current = queue.front();
-            queue.pop();
+            m_path_results[q].source = queries[q].first;
+            m_path_results[q].target = queries[q].second;
 
-            if (current == target)
+            int source_id = find_node(queries[q].first);
+            if (source_id < 0 || find_node(queries[q].second) < 0)
             {
-                found = true;
-                break;
+                cerr << "Warning: Skipping path query " << queries[q].first << " -> " << queries[q].second
+                     << " (node not found in graph)" << endl;
+                continue;
             }
 
-            for (const string &neighbor : m_adjacency_list[current])
+            auto inserted = group_of_source.emplace(source_id, group_sources.size());
+            if (inserted.second)
             {
-                if (visited.find(neighbor) == visited.end())
-                {
-                    visited.insert(neighbor);
-                    prev[neighbor] = current;
-
-                    queue.push(neighbor);
-                }
+                group_sources.push_back(source_id);
+                group_queries.emplace_back();
             }
+            group_queries[inserted.first->second].push_back(q);
         }
 
-        // Reconstruct path if found
-        if (found)
-        {
-            string current = target;
-            while (current != source)
+        // One PathFinder (and its scratch arrays) per batch of groups
+        utils::ThreadPool &pool = utils::ThreadPool::shared();
+        size_t batch_count = min(pool.size(), group_sources.size());
+
+        pool.parallel_for(batch_count, [&](size_t batch)
+                          {
+            PathFinder finder(m_row_begin, m_row_end, m_neighbors, costs);
+            vector<int> path;
+            vector<int> targets;
+            vector<vector<int>> paths;
+            vector<double> path_costs;
+
+            for (size_t g = batch; g < group_sources.size(); g += batch_count)
             {
-                path.push_back(current);
-                current = prev[current];
-            }
-            path.push_back(source);
+                const vector<size_t> &group = group_queries[g];
 
-            // Reverse to get path from source to target
-            reverse(path.begin(), path.end());
+                // A single target is cheapest to reach from both ends
+                if (group.size() == 1)
+                {
+                    PathResult &result = m_path_results[group[0]];
+                    if (finder.find_path(group_sources[g], find_node(result.target), path, result.cost))
+                    {
+                        result.path = node_names(path);
+                    }
+                    continue;
+                }
+
+                targets.clear();
+                for (size_t q : group)
+                {
+                    targets.push_back(find_node(m_path_results[q].target));
+                }
+
+                finder.find_paths(group_sources[g], targets, paths, path_costs);
+                for (size_t i = 0; i < group.size(); ++i)
+                {
+                    m_path_results[group[i]].path = node_names(paths[i]);
+                    m_path_results[group[i]].cost = path_costs[i];
+                }
+            } });
+
+        size_t found = 0;
+        for (const PathResult &result : m_path_results)
+        {
+            found += result.found() ? 1 : 0;
         }
 
-        return path;
+        double elapsed_ms = chrono::duration<double, milli>(chrono::high_resolution_clock::now() - start_time).count();
+        cout << "Path queries complete:" << endl;
+        cout << "  - Answered " << queries.size() << " queries from " << group_sources.size() << " sources, "
+             << found << " connected" << endl;
+        cout << "  - Execution time: " << elapsed_ms << " ms" << endl;
+
+        return m_path_results;
     }
 
     bool GraphAnalyzer::export_results(const string &filename)
     {
+        // Live updates are exported as they are, skipping the tombstones
+        if (!m_packed)
+        {
+            resolve_component_splits();
+            label_components();
+            refresh_degree_centrality();
+        }
+
         utils::JSONExporter exporter;
 
-        // Add nodes array
-        exporter.start_array("nodes");
-        size_t node_count = 0;
+        // Add nodes array, sorted by name
+        vector<int> order;
+        order.reserve(m_nodes.size() - m_removed_node_count);
+        for (size_t u = 0; u < m_nodes.size(); ++u)
+        {
+            if (!m_removed_nodes[u])
+            {
+                order.push_back(static_cast<int>(u));
+            }
+        }
+        sort(order.begin(), order.end(), [this](int a, int b)
+             { return m_nodes[a].id < m_nodes[b].id; });
 
-        for (const auto &[node_id, node] : m_nodes)
+        exporter.start_array("nodes");
+        for (size_t i = 0; i < order.size(); ++i)
         {
+            const Node &node = m_nodes[order[i]];
+
             map<string, string> node_obj = {
-                {"id", node_id},
+                {"id", node.id},
                 {"degree", to_string(node.degree)},
-                {"centrality", to_string(node.centrality)}};
-            node_count++;
-
-            exporter.add_object_to_array(node_obj, node_count == m_nodes.size());
+                {"centrality", to_string(node.centrality)},
+                {"betweenness", to_string(node.betweenness)},
+                {"closeness", to_string(node.closeness)},
+                {"harmonic", to_string(node.harmonic)},
+                {"pagerank", to_string(node.pagerank)},
+                {"eigenvector", to_string(node.eigenvector)},
+                {"component", to_string(node.component)},
+                {"community", to_string(node.community)}};
+            exporter.add_object_to_array(node_obj, i == order.size() - 1);
         }
         exporter.end_array();
 
         // Add edges array
         exporter.start_array("edges");
-        for (size_t i = 0; i < m_edges.size(); ++i)
+        size_t edges_left = m_edges.size() - m_removed_edge_count;
+        for (const Edge &edge : m_edges)
         {
-            const Edge &edge = m_edges[i];
+            if (edge.source < 0)
+            {
+                continue;
+            }
 
             map<string, string> edge_obj = {
-                {"source", edge.source},
-                {"target", edge.target},
+                {"source", m_nodes[edge.source].id},
+                {"target", m_nodes[edge.target].id},
                 {"weight", to_string(edge.weight)}};
-            exporter.add_object_to_array(edge_obj, i == m_edges.size() - 1);
+            exporter.add_object_to_array(edge_obj, --edges_left == 0);
         }
         exporter.end_array();
 
+        // Add network structure summary
+        exporter.add_int("component_count", m_component_count);
+        exporter.add_int("community_count", m_community_count);
+        exporter.add_double("modularity", m_modularity);
+
         // Add BFS traversal
-        exporter.add_string_array("bfs_order", m_bfs_order);
+        exporter.add_string_array("bfs_order", node_names(m_bfs_order));
+
+        // BFS level of each node, in BFS order
+        vector<int> bfs_levels;
+        for (int node : m_bfs_order)
+        {
+            bfs_levels.push_back(m_bfs_levels[node]);
+        }
+        exporter.add_int_array("bfs_levels", bfs_levels);
 
         // Add DFS traversal
-        exporter.add_string_array("dfs_order", m_dfs_order);
+        exporter.add_string_array("dfs_order", node_names(m_dfs_order));
+
+        // DFS discovery and finish times, in DFS order
+        exporter.start_array("dfs_times");
+        for (size_t i = 0; i < m_dfs_order.size(); ++i)
+        {
+            int node = m_dfs_order[i];
+
+            map<string, string> time_obj = {
+                {"id", m_nodes[node].id},
+                {"discovery", to_string(m_dfs_discovery[node])},
+                {"finish", to_string(m_dfs_finish[node])}};
+            exporter.add_object_to_array(time_obj, i == m_dfs_order.size() - 1);
+        }
+        exporter.end_array();
+
+        // Add weighted path query results
+        if (!m_path_results.empty())
+        {
+            exporter.start_array("paths");
+            for (size_t i = 0; i < m_path_results.size(); ++i)
+            {
+                const PathResult &result = m_path_results[i];
+
+                exporter.start_object();
+                exporter.add_string("source", result.source);
+                exporter.add_string("target", result.target);
+                exporter.add_bool("found", result.found());
+                if (result.found())
+                {
+                    exporter.add_double("cost", result.cost);
+                    exporter.add_double("confidence", exp(-result.cost));
+                    exporter.add_int("hops", static_cast<long long>(result.path.size()) - 1);
+                    exporter.add_string_array("path", result.path);
+                }
+                exporter.end_object(i == m_path_results.size() - 1);
+            }
+            exporter.end_array();
+        }
 
         return exporter.export_to_file(filename);
     }
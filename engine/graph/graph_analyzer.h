@@ -10,6 +10,7 @@
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include "node_name_map.h"
 #include "../utils/json_exporter.h"
 
 using namespace std;
@@ -17,14 +18,14 @@ using namespace std;
 namespace graph
 {
 
-    // Edge structure to represent interaction between two nodes
+    // Edge structure to represent interaction between two nodes (by node ID)
     struct Edge
     {
-        string source;
-        string target;
+        int source;
+        int target;
         double weight; // Optional weight/confidence value
 
-        Edge(const string &src, const string &tgt, double w = 1.0)
+        Edge(int src, int tgt, double w = 1.0)
             : source(src), target(tgt), weight(w) {}
     };
 
@@ -34,11 +35,40 @@ namespace graph
         string id;
         int degree;
         double centrality;
+        double betweenness;
+        double closeness;
+        double harmonic;
+        double pagerank;
+        double eigenvector;
+        int component; // Connected component ID
+        int community; // Louvain community ID
 
-        Node() : id(""), degree(0), centrality(0.0) {}
+        Node() : id(""), degree(0), centrality(0.0), betweenness(0.0), closeness(0.0), harmonic(0.0),
+                 pagerank(0.0), eigenvector(0.0), component(-1), community(-1) {}
 
         Node(const string &nodeId)
-            : id(nodeId), degree(0), centrality(0.0) {}
+            : id(nodeId), degree(0), centrality(0.0), betweenness(0.0), closeness(0.0), harmonic(0.0),
+              pagerank(0.0), eigenvector(0.0), component(-1), community(-1) {}
+    };
+
+    // Result of a weighted path query. Edge weights are confidences, so an edge
+    // costs -log(confidence) and the cheapest path is the most confident one.
+    struct PathResult
+    {
+        string source;
+        string target;
+        vector<string> path; // Empty if a node is unknown or the two are not connected
+        double cost = 0.0;
+
+        bool found() const { return !path.empty(); }
+    };
+
+    // Interaction between two named nodes, for live updates
+    struct Interaction
+    {
+        string source;
+        string target;
+        double weight = 1.0;
     };
 
     class GraphAnalyzer
@@ -47,35 +77,171 @@ namespace graph
         GraphAnalyzer() = default;
         ~GraphAnalyzer() = default;
 
-        // Load interactions from CSV file
+        // Load interactions from CSV file (or from a snapshot, recognized by its header)
         bool load_interactions(const string &filename);
 
+        // Versioned binary snapshot of the graph: name table, edges, CSR arrays
+        // and the cached scores, each stored as a raw aligned array. Loading maps
+        // the file and bulk-copies the arrays, with no parsing or interning, so
+        // the graph stays updatable; only the name lookup table is rebuilt.
+        bool save_snapshot(const string &filename);
+        bool load_snapshot(const string &filename);
+
+        // Estimate betweenness and closeness from this many random source nodes
+        // instead of all of them (0 = exact); meant for graphs too big for O(VE)
+        void set_centrality_pivots(size_t pivots, unsigned seed = 42)
+        {
+            m_centrality_pivots = pivots;
+            m_centrality_seed = seed;
+        }
+
+        // Live updates, without reloading the file. Each call costs time in
+        // proportion to its batch (amortized): rows of the adjacency get slack and
+        // move to the end of the arrays when full, removed edges and nodes become
+        // tombstones, degrees and degree centrality follow every entry, and
+        // components are kept in a union-find. Path queries and exports read the
+        // rows as they are. The arrays are packed again (O(V + E)) only once the
+        // garbage outweighs the live graph, or before analyze() and
+        // save_snapshot(), which need a packed CSR. A removal only recounts the
+        // components it touched. The other scores keep their old values (and
+        // warm-start PageRank) until analyze() runs again.
+        bool add_node(const string &name);    // False if the node already exists
+        bool remove_node(const string &name); // Also removes its interactions
+        size_t add_interactions(const vector<Interaction> &interactions);
+
+        // Remove every interaction between each pair of nodes (either direction);
+        // returns the number of interactions removed
+        size_t remove_interactions(const vector<pair<string, string>> &pairs);
+
         // Analyze the graph starting from a specific node
         void analyze(const string &start_node);
 
+        // Most confident path between two nodes (bidirectional Dijkstra)
+        PathResult find_path(const string &source, const string &target);
+
+        // Answer a batch of (source, target) queries: queries sharing a source share
+        // one Dijkstra run, and sources are spread over the thread pool. The results
+        // are kept for the export.
+        const vector<PathResult> &find_paths(const vector<pair<string, string>> &queries);
+
         // Export results to JSON
         bool export_results(const string &filename);
 
     private:
-        // Adjacency list representation of the graph
-        unordered_map<string, vector<string>> m_adjacency_list;
-
-        // Store nodes and edges
-        map<string, Node> m_nodes;
+        // Nodes are interned to dense IDs at load time; m_nodes[id].id holds the name
+        vector<Node> m_nodes;
+        NodeNameMap m_node_ids;
         vector<Edge> m_edges;
 
-        // Store traversal results
-        vector<string> m_bfs_order;
-        vector<string> m_dfs_order;
+        // Compressed sparse row adjacency (undirected): the neighbors of node u are
+        // m_neighbors[m_offsets[u] .. m_offsets[u + 1]), in edge file order
+        vector<size_t> m_offsets;
+        vector<int> m_neighbors;
+        vector<double> m_neighbor_weights;
+        vector<int> m_neighbor_edges;    // Index in m_edges of every CSR entry
+        vector<double> m_neighbor_costs; // -log(weight) per CSR entry, built by the first path query
+
+        // Row u of the adjacency is m_neighbors[m_row_begin[u] .. m_row_end[u]),
+        // with room up to m_row_begin[u] + m_row_capacity[u]. While m_packed the
+        // rows are exactly the CSR rows; after a live update m_offsets is out of
+        // date and the arrays hold holes, counted by the live totals below.
+        vector<size_t> m_row_begin;
+        vector<size_t> m_row_end;
+        vector<size_t> m_row_capacity;
+        vector<bool> m_removed_nodes;
+        bool m_packed = true;
+        size_t m_entry_count = 0;        // Live CSR entries
+        size_t m_removed_edge_count = 0; // Tombstones in m_edges
+        size_t m_removed_node_count = 0; // Tombstones in m_nodes
+        size_t m_degree_scale_nodes = 0; // Node count that Node::centrality is normalized by
+
+        // Union-find over node IDs, kept up to date as edges are added; every
+        // set is a superset of a component. A removal records its endpoints as
+        // seeds: each piece of a set that may have split holds one, so only
+        // those sets are recounted, by a BFS from the seeds.
+        vector<int> m_component_parent;
+        vector<int> m_split_seeds;
+
+        // Store traversal results (node IDs)
+        vector<int> m_bfs_order;
+        vector<int> m_bfs_levels; // BFS distance from the start node per node ID (-1 if not reached)
+        vector<int> m_dfs_order;
+
+        // DFS discovery and finish times per node ID (-1 if not reached)
+        vector<int> m_dfs_discovery;
+        vector<int> m_dfs_finish;
+
+        // Sampling for betweenness/closeness (0 pivots = exact)
+        size_t m_centrality_pivots = 0;
+        unsigned m_centrality_seed = 42;
+
+        // Network structure summary
+        int m_component_count = 0;
+        int m_community_count = 0;
+        double m_modularity = 0.0;
+
+        // Results of the last batch of path queries
+        vector<PathResult> m_path_results;
+
+        // ID of a node name, or -1 if it is not in the graph
+        int find_node(const string &name) const;
+
+        // True if the file starts with the snapshot magic
+        static bool is_snapshot(const string &filename);
+
+        // Freeze m_edges into the CSR arrays
+        void build_csr();
+
+        // Make the rows the packed CSR rows again, with no tombstones
+        void reset_rows();
+
+        // Live update helpers
+        void begin_update();
+        int intern_node(const string &name);
+        void append_row_entry(int node, int neighbor, double weight, int edge);
+        size_t remove_row_entries(int node, int neighbor); // Keeps the order of the rest
+        int component_root(int node);
+        void unite_components(int a, int b);
+        void reset_component_forest(const vector<int> &component);
+
+        // Recount the union-find sets holding split seeds
+        void resolve_component_splits();
+
+        // Dense component labels in order of each component's smallest live node
+        void label_components();
+
+        // Normalize degree centrality again if the node count changed
+        void refresh_degree_centrality();
+
+        // Drop tombstones, renumber the nodes and pack the CSR again
+        void compact_updates();
+
+        // Compact once holes and tombstones outnumber the live graph
+        void compact_if_sparse();
 
         // Graph analysis methods
         void calculate_degree_centrality();
-        vector<string> bfs_traversal(const string &start_node);
-        vector<string> dfs_traversal(const string &start_node);
-        void dfs_helper(const string &node, unordered_set<string> &visited, vector<string> &result);
+        void calculate_path_centrality();
+
+        // PageRank and eigenvector centrality, warm-started from the previous
+        // scores (kept by node name across reloads of a slightly changed file)
+        void calculate_spectral_centrality();
+
+        // Connected components (union-find), labeled at load time and after updates
+        void calculate_components();
+
+        // Louvain communities of the whole network
+        void calculate_communities();
+
+        // Direction-optimizing parallel BFS; also fills m_bfs_levels
+        vector<int> bfs_traversal(int start_node);
+        vector<int> dfs_traversal(int start_node);
+
+        // Edge costs for path queries, computed on first use
+        const vector<double> &path_costs();
 
-        // shortest path calculation
-        vector<string> shortest_path(const string &source, const string &target);
+        // Names of a list of node IDs
+        vector<string> node_names(const vector<int> &ids) const;
     };
 
 } // namespace graph
@@ -0,0 +1,331 @@
+#include "graph_analyzer.h"
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include "../utils/mapped_file.h"
+
+using namespace std;
+
+namespace graph
+{
+
+    namespace
+    {
+        const char SNAPSHOT_MAGIC[8] = {'B', 'S', 'E', 'G', 'R', 'A', 'P', 'H'};
+        const uint32_t SNAPSHOT_VERSION = 1;
+        const uint32_t BYTE_ORDER_MARK = 0x01020304; // Arrays are stored in native byte order
+
+        static_assert(sizeof(int) == sizeof(int32_t), "snapshot arrays store node IDs as 32-bit integers");
+
+        // Fixed-size header. The arrays follow in the order written by
+        // save_snapshot, each padded to a multiple of 8 bytes, so all of them
+        // are aligned inside the mapping.
+        struct SnapshotHeader
+        {
+            char magic[8];
+            uint32_t version;
+            uint32_t byte_order;
+            uint64_t node_count;
+            uint64_t edge_count;
+            uint64_t entry_count; // CSR entries, two per edge
+            uint64_t name_bytes;
+            int64_t component_count;
+            int64_t community_count;
+            double modularity;
+        };
+
+        template <typename T>
+        void write_array(ofstream &file, const T *values, size_t count)
+        {
+            static const char padding[8] = {};
+            size_t bytes = count * sizeof(T);
+            file.write(reinterpret_cast<const char *>(values), bytes);
+            file.write(padding, (8 - bytes % 8) % 8);
+        }
+
+        template <typename T>
+        void write_array(ofstream &file, const vector<T> &values)
+        {
+            write_array(file, values.data(), values.size());
+        }
+
+        // One Node field for every node, as an array
+        template <typename T, typename Field>
+        void write_node_field(ofstream &file, const vector<Node> &nodes, Field field)
+        {
+            vector<T> values;
+            values.reserve(nodes.size());
+            for (const Node &node : nodes)
+            {
+                values.push_back(node.*field);
+            }
+            write_array(file, values);
+        }
+
+        // Copies the arrays out of the mapping in file order, checking every bound
+        class SnapshotReader
+        {
+        public:
+            SnapshotReader(const char *data, size_t size, size_t position)
+                : m_data(data), m_size(size), m_position(position) {}
+
+            template <typename T>
+            bool read(uint64_t count, vector<T> &values)
+            {
+                if (count > (m_size - m_position) / sizeof(T))
+                {
+                    return false;
+                }
+
+                const T *first = reinterpret_cast<const T *>(m_data + m_position);
+                values.assign(first, first + count);
+
+                size_t bytes = count * sizeof(T);
+                m_position = min(m_size, m_position + bytes + (8 - bytes % 8) % 8);
+                return true;
+            }
+
+            template <typename T, typename Field>
+            bool read_node_field(vector<Node> &nodes, Field field)
+            {
+                vector<T> values;
+                if (!read(nodes.size(), values))
+                {
+                    return false;
+                }
+                for (size_t u = 0; u < nodes.size(); ++u)
+                {
+                    nodes[u].*field = values[u];
+                }
+                return true;
+            }
+
+        private:
+            const char *m_data;
+            size_t m_size;
+            size_t m_position;
+        };
+
+        // Offsets must start at 0, never decrease and end at total
+        bool valid_offsets(const vector<uint64_t> &offsets, uint64_t total)
+        {
+            if (offsets.empty() || offsets.front() != 0 || offsets.back() != total)
+            {
+                return false;
+            }
+            for (size_t i = 1; i < offsets.size(); ++i)
+            {
+                if (offsets[i] < offsets[i - 1])
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        bool valid_ids(const vector<int> &ids, uint64_t count)
+        {
+            for (int id : ids)
+            {
+                if (id < 0 || static_cast<uint64_t>(id) >= count)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+    }
+
+    bool GraphAnalyzer::is_snapshot(const string &filename)
+    {
+        ifstream file(filename, ios::binary);
+        char magic[sizeof(SNAPSHOT_MAGIC)];
+        return file.read(magic, sizeof(magic)) && memcmp(magic, SNAPSHOT_MAGIC, sizeof(magic)) == 0;
+    }
+
+    bool GraphAnalyzer::save_snapshot(const string &filename)
+    {
+        compact_updates();
+
+        ofstream file(filename, ios::binary);
+        if (!file.is_open())
+        {
+            cerr << "Error: Could not open file " << filename << endl;
+            return false;
+        }
+
+        // Names as one character blob plus offsets into it
+        vector<uint64_t> name_offsets(1, 0);
+        string names;
+        for (const Node &node : m_nodes)
+        {
+            names += node.id;
+            name_offsets.push_back(names.size());
+        }
+
+        SnapshotHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+        header.version = SNAPSHOT_VERSION;
+        header.byte_order = BYTE_ORDER_MARK;
+        header.node_count = m_nodes.size();
+        header.edge_count = m_edges.size();
+        header.entry_count = m_neighbors.size();
+        header.name_bytes = names.size();
+        header.component_count = m_component_count;
+        header.community_count = m_community_count;
+        header.modularity = m_modularity;
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+        write_array(file, name_offsets);
+        write_array(file, names.data(), names.size());
+
+        vector<int> sources, targets;
+        vector<double> weights;
+        sources.reserve(m_edges.size());
+        targets.reserve(m_edges.size());
+        weights.reserve(m_edges.size());
+        for (const Edge &edge : m_edges)
+        {
+            sources.push_back(edge.source);
+            targets.push_back(edge.target);
+            weights.push_back(edge.weight);
+        }
+        write_array(file, sources);
+        write_array(file, targets);
+        write_array(file, weights);
+
+        vector<uint64_t> offsets(m_offsets.begin(), m_offsets.end());
+        write_array(file, offsets);
+        write_array(file, m_neighbors);
+        write_array(file, m_neighbor_weights);
+        write_array(file, m_neighbor_edges);
+
+        // Cached scores, so a reload can export or warm-start without reanalyzing
+        write_node_field<int>(file, m_nodes, &Node::degree);
+        write_node_field<double>(file, m_nodes, &Node::centrality);
+        write_node_field<double>(file, m_nodes, &Node::betweenness);
+        write_node_field<double>(file, m_nodes, &Node::closeness);
+        write_node_field<double>(file, m_nodes, &Node::harmonic);
+        write_node_field<double>(file, m_nodes, &Node::pagerank);
+        write_node_field<double>(file, m_nodes, &Node::eigenvector);
+        write_node_field<int>(file, m_nodes, &Node::component);
+        write_node_field<int>(file, m_nodes, &Node::community);
+
+        return static_cast<bool>(file);
+    }
+
+    bool GraphAnalyzer::load_snapshot(const string &filename)
+    {
+        auto start_time = chrono::high_resolution_clock::now();
+
+        utils::MappedFile file;
+        if (!file.open(filename))
+        {
+            cerr << "Error: Could not open file " << filename << endl;
+            return false;
+        }
+
+        SnapshotHeader header;
+        if (file.size() < sizeof(header))
+        {
+            cerr << "Error: " << filename << " is not a supported graph snapshot" << endl;
+            return false;
+        }
+        memcpy(&header, file.data(), sizeof(header));
+        if (memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0 ||
+            header.version != SNAPSHOT_VERSION || header.byte_order != BYTE_ORDER_MARK)
+        {
+            cerr << "Error: " << filename << " is not a supported graph snapshot" << endl;
+            return false;
+        }
+
+        // Everything is read into new arrays first, so a bad file leaves the
+        // current graph untouched
+        SnapshotReader reader(file.data(), file.size(), sizeof(header));
+        vector<uint64_t> name_offsets, offsets;
+        vector<char> names;
+        vector<int> sources, targets, neighbors, neighbor_edges;
+        vector<double> weights, neighbor_weights;
+        vector<Node> nodes(header.node_count < file.size() ? header.node_count : 0);
+
+        bool valid = nodes.size() == header.node_count &&
+                     reader.read(header.node_count + 1, name_offsets) && reader.read(header.name_bytes, names) &&
+                     reader.read(header.edge_count, sources) && reader.read(header.edge_count, targets) &&
+                     reader.read(header.edge_count, weights) && reader.read(header.node_count + 1, offsets) &&
+                     reader.read(header.entry_count, neighbors) && reader.read(header.entry_count, neighbor_weights) &&
+                     reader.read(header.entry_count, neighbor_edges) &&
+                     reader.read_node_field<int>(nodes, &Node::degree) &&
+                     reader.read_node_field<double>(nodes, &Node::centrality) &&
+                     reader.read_node_field<double>(nodes, &Node::betweenness) &&
+                     reader.read_node_field<double>(nodes, &Node::closeness) &&
+                     reader.read_node_field<double>(nodes, &Node::harmonic) &&
+                     reader.read_node_field<double>(nodes, &Node::pagerank) &&
+                     reader.read_node_field<double>(nodes, &Node::eigenvector) &&
+                     reader.read_node_field<int>(nodes, &Node::component) &&
+                     reader.read_node_field<int>(nodes, &Node::community);
+
+        valid = valid && header.entry_count == 2 * header.edge_count &&
+                valid_offsets(name_offsets, header.name_bytes) && valid_offsets(offsets, header.entry_count) &&
+                valid_ids(sources, header.node_count) && valid_ids(targets, header.node_count) &&
+                valid_ids(neighbors, header.node_count) && valid_ids(neighbor_edges, header.edge_count) &&
+                header.component_count >= 0;
+
+        // Component labels must be numbered in order of their smallest node
+        vector<int> component(nodes.size());
+        int64_t label_count = 0;
+        for (size_t u = 0; valid && u < nodes.size(); ++u)
+        {
+            component[u] = nodes[u].component;
+            valid = component[u] >= 0 && component[u] <= label_count;
+            label_count += component[u] == label_count ? 1 : 0;
+        }
+        valid = valid && label_count == header.component_count;
+
+        NodeNameMap node_ids;
+        for (size_t u = 0; valid && u < nodes.size(); ++u)
+        {
+            nodes[u].id.assign(names.data() + name_offsets[u], name_offsets[u + 1] - name_offsets[u]);
+            valid = node_ids.emplace(nodes[u].id, static_cast<int>(u)).second;
+        }
+
+        if (!valid || nodes.empty())
+        {
+            cerr << "Error: Graph snapshot " << filename << " is truncated or corrupt" << endl;
+            return false;
+        }
+
+        m_nodes.swap(nodes);
+        m_node_ids = move(node_ids);
+        m_edges.clear();
+        m_edges.reserve(sources.size());
+        for (size_t e = 0; e < sources.size(); ++e)
+        {
+            m_edges.emplace_back(sources[e], targets[e], weights[e]);
+        }
+        m_offsets.assign(offsets.begin(), offsets.end());
+        m_neighbors.swap(neighbors);
+        m_neighbor_weights.swap(neighbor_weights);
+        m_neighbor_edges.swap(neighbor_edges);
+        m_component_count = static_cast<int>(header.component_count);
+        m_community_count = static_cast<int>(header.community_count);
+        m_modularity = header.modularity;
+        reset_component_forest(component);
+
+        reset_rows();
+        m_degree_scale_nodes = m_nodes.size();
+        m_neighbor_costs.clear();
+        m_path_results.clear();
+        m_bfs_order.clear();
+        m_bfs_levels.clear();
+        m_dfs_order.clear();
+        m_dfs_discovery.clear();
+        m_dfs_finish.clear();
+
+        double elapsed_ms = chrono::duration<double, milli>(chrono::high_resolution_clock::now() - start_time).count();
+        cout << "Successfully loaded " << m_nodes.size() << " nodes and " << m_edges.size() << " interactions" << endl;
+        cout << "  - Mapped " << file.size() << " byte snapshot in " << elapsed_ms << " ms" << endl;
+        return true;
+    }
+
+} // namespace graph
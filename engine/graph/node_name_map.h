@@ -0,0 +1,69 @@
+#ifndef NODE_NAME_MAP_H
+#define NODE_NAME_MAP_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace graph
+{
+
+    // Node name -> node ID map, split into SHARD_COUNT independent hash tables
+    // by the name's hash. Every shard can be filled by a different thread, so
+    // interning a large file never funnels all names through one table.
+    class NodeNameMap
+    {
+    public:
+        static const size_t SHARD_COUNT = 64;
+
+        NodeNameMap() : m_shards(SHARD_COUNT) {}
+
+        static size_t shard_of(std::string_view name)
+        {
+            // Top bits of a multiplicative mix, independent of the bits the
+            // shard tables use for their buckets
+            uint64_t hash = std::hash<std::string_view>()(name);
+            return static_cast<size_t>((hash * 0x9E3779B97F4A7C15ull) >> 58);
+        }
+
+        // ID of a name, or -1
+        int find(const std::string &name) const
+        {
+            const std::unordered_map<std::string, int> &table = m_shards[shard_of(name)];
+            auto it = table.find(name);
+            return it == table.end() ? -1 : it->second;
+        }
+
+        // Insert a name unless present; returns its ID and whether it was added
+        std::pair<int, bool> emplace(const std::string &name, int id)
+        {
+            auto inserted = m_shards[shard_of(name)].emplace(name, id);
+            return {inserted.first->second, inserted.second};
+        }
+
+        void assign(const std::string &name, int id) { m_shards[shard_of(name)][name] = id; }
+
+        void erase(const std::string &name) { m_shards[shard_of(name)].erase(name); }
+
+        void clear()
+        {
+            for (std::unordered_map<std::string, int> &table : m_shards)
+            {
+                table.clear();
+            }
+        }
+
+        // Direct access for filling shards in parallel; a name must go to shard_of(name)
+        std::unordered_map<std::string, int> &shard(size_t index) { return m_shards[index]; }
+
+    private:
+        std::vector<std::unordered_map<std::string, int>> m_shards;
+    };
+
+} // namespace graph
+
+#endif // NODE_NAME_MAP_H
@@ -0,0 +1,305 @@
+#include "parallel_bfs.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include "../utils/thread_pool.h"
+
+using namespace std;
+
+namespace graph
+{
+
+    namespace
+    {
+        // Beamer's switching thresholds: go bottom-up once the frontier has more
+        // than 1/ALPHA of the unexplored edges, back to top-down once it holds
+        // fewer than 1/BETA of the nodes
+        const size_t ALPHA = 14;
+        const size_t BETA = 24;
+
+        const size_t MIN_RANGE_SIZE = 1024; // Frontier nodes (or bitmap words) per task
+        const size_t RANGES_PER_THREAD = 8; // Spare ranges to balance skewed degrees
+
+        class Bitmap
+        {
+        public:
+            explicit Bitmap(size_t n) : m_words((n + 63) / 64)
+            {
+                for (atomic<uint64_t> &word : m_words)
+                {
+                    word.store(0, memory_order_relaxed);
+                }
+            }
+
+            size_t word_count() const { return m_words.size(); }
+
+            bool test(int node) const
+            {
+                return (m_words[node >> 6].load(memory_order_relaxed) >> (node & 63)) & 1;
+            }
+
+            // Returns true if this call set the bit
+            bool set(int node)
+            {
+                uint64_t bit = uint64_t(1) << (node & 63);
+                return !(m_words[node >> 6].fetch_or(bit, memory_order_relaxed) & bit);
+            }
+
+            void reset(int node)
+            {
+                m_words[node >> 6].fetch_and(~(uint64_t(1) << (node & 63)), memory_order_relaxed);
+            }
+
+        private:
+            vector<atomic<uint64_t>> m_words;
+        };
+
+        size_t range_count(size_t n)
+        {
+            size_t wanted = (n + MIN_RANGE_SIZE - 1) / MIN_RANGE_SIZE;
+            return max<size_t>(1, min(utils::ThreadPool::shared().size() * RANGES_PER_THREAD, wanted));
+        }
+
+        template <typename Task>
+        void for_each_range(size_t n, size_t count, const Task &task)
+        {
+            utils::ThreadPool::shared().parallel_for(count, [&](size_t range)
+                                                     { task(n * range / count, n * (range + 1) / count, range); });
+        }
+
+        // Sequential BFS order from the levels. A queue BFS appends a node of
+        // level d + 1 when it dequeues the node's first parent, i.e. the level d
+        // neighbor with the smallest rank, and one parent's children follow
+        // its row order. So per level: every node finds its parent (one task
+        // per range of nodes, reading only its own row), the nodes are grouped
+        // by parent rank, and only parents with several children scan their
+        // row to order them. No edge is claimed and nothing is atomic.
+        void order_by_levels(const vector<size_t> &offsets, const vector<int> &neighbors, const vector<int> &level,
+                             const vector<int> &by_level, const vector<size_t> &level_begin, vector<int> &order)
+        {
+            const int NO_RANK = INT32_MAX;
+            size_t n = offsets.size() - 1;
+            vector<int> rank(n, NO_RANK);    // Position in order, once placed
+            vector<int> parent_rank(n, 0);   // Rank of the first parent, next level only
+            vector<size_t> group_begin;
+
+            order.assign(by_level.size(), 0);
+            order[0] = by_level[0];
+            rank[by_level[0]] = 0;
+
+            for (size_t depth = 0; depth + 2 < level_begin.size(); ++depth)
+            {
+                size_t parents_begin = level_begin[depth];
+                size_t parent_count = level_begin[depth + 1] - parents_begin;
+                size_t children_begin = level_begin[depth + 1];
+                size_t child_count = level_begin[depth + 2] - children_begin;
+                int parent_level = static_cast<int>(depth);
+
+                for_each_range(child_count, range_count(child_count), [&](size_t begin, size_t end, size_t)
+                               {
+                    for (size_t i = begin; i < end; ++i)
+                    {
+                        int w = by_level[children_begin + i];
+                        int best = NO_RANK;
+                        for (size_t e = offsets[w]; e < offsets[w + 1]; ++e)
+                        {
+                            int v = neighbors[e];
+                            if (level[v] == parent_level && rank[v] < best)
+                            {
+                                best = rank[v];
+                            }
+                        }
+                        parent_rank[w] = best;
+                    } });
+
+                // Slots of every parent's children, in parent order
+                group_begin.assign(parent_count + 1, 0);
+                for (size_t i = 0; i < child_count; ++i)
+                {
+                    group_begin[parent_rank[by_level[children_begin + i]] - parents_begin + 1]++;
+                }
+                for (size_t r = 0; r < parent_count; ++r)
+                {
+                    group_begin[r + 1] += group_begin[r];
+                }
+
+                // An only child needs no ordering
+                for (size_t i = 0; i < child_count; ++i)
+                {
+                    int w = by_level[children_begin + i];
+                    size_t r = parent_rank[w] - parents_begin;
+                    if (group_begin[r + 1] - group_begin[r] == 1)
+                    {
+                        order[children_begin + group_begin[r]] = w;
+                        rank[w] = static_cast<int>(children_begin + group_begin[r]);
+                    }
+                }
+
+                for_each_range(parent_count, range_count(parent_count), [&](size_t begin, size_t end, size_t)
+                               {
+                    for (size_t r = begin; r < end; ++r)
+                    {
+                        size_t slot = children_begin + group_begin[r];
+                        if (group_begin[r + 1] - group_begin[r] < 2)
+                        {
+                            continue;
+                        }
+
+                        // Only this task touches the rank of this parent's children, so it marks them as placed
+                        int v = order[parents_begin + r];
+                        for (size_t e = offsets[v]; e < offsets[v + 1]; ++e)
+                        {
+                            int w = neighbors[e];
+                            if (level[w] == parent_level + 1 && parent_rank[w] == static_cast<int>(parents_begin + r) &&
+                                rank[w] == NO_RANK)
+                            {
+                                order[slot] = w;
+                                rank[w] = static_cast<int>(slot);
+                                slot++;
+                            }
+                        }
+                    } });
+            }
+        }
+    }
+
+    void parallel_bfs(const vector<size_t> &offsets, const vector<int> &neighbors, int source,
+                      bool with_order, BFSResult &result)
+    {
+        size_t n = offsets.size() - 1;
+        result.level.assign(n, -1);
+        result.order.clear();
+        result.top_down_steps = 0;
+        result.bottom_up_steps = 0;
+        if (source < 0 || static_cast<size_t>(source) >= n)
+        {
+            return;
+        }
+
+        vector<int> &level = result.level;
+        Bitmap visited(n), in_frontier(n), in_next(n);
+
+        vector<int> frontier(1, source);
+        vector<vector<int>> found(utils::ThreadPool::shared().size() * RANGES_PER_THREAD);
+        visited.set(source);
+        level[source] = 0;
+
+        // Nodes of level d in by_level[level_begin[d], level_begin[d + 1]), for the order
+        vector<int> by_level;
+        vector<size_t> level_begin(1, 0);
+        if (with_order)
+        {
+            by_level.push_back(source);
+            level_begin.push_back(1);
+        }
+
+        size_t unexplored = neighbors.size() - (offsets[source + 1] - offsets[source]);
+        bool bottom_up = false;
+
+        for (int depth = 0; !frontier.empty(); ++depth)
+        {
+            size_t frontier_edges = 0;
+            for (int v : frontier)
+            {
+                frontier_edges += offsets[v + 1] - offsets[v];
+            }
+
+            if (!bottom_up && frontier_edges > unexplored / ALPHA)
+            {
+                bottom_up = true;
+            }
+            else if (bottom_up && frontier.size() < n / BETA)
+            {
+                bottom_up = false;
+            }
+
+            size_t ranges = range_count(frontier.size());
+
+            if (bottom_up)
+            {
+                result.bottom_up_steps++;
+                for (int v : frontier)
+                {
+                    in_frontier.set(v);
+                }
+
+                // Every unvisited node looks for any parent in the frontier.
+                // Ranges are whole bitmap words, so one thread owns each node.
+                size_t words = visited.word_count();
+                ranges = range_count(words);
+                for_each_range(words, ranges, [&](size_t begin, size_t end, size_t range)
+                               {
+                    size_t last = min(n, end * 64);
+                    for (size_t u = begin * 64; u < last; ++u)
+                    {
+                        int node = static_cast<int>(u);
+                        if (visited.test(node))
+                        {
+                            continue;
+                        }
+                        for (size_t e = offsets[u]; e < offsets[u + 1]; ++e)
+                        {
+                            if (in_frontier.test(neighbors[e]))
+                            {
+                                in_next.set(node);
+                                level[u] = depth + 1;
+                                found[range].push_back(node);
+                                break;
+                            }
+                        }
+                    } });
+
+                for (int v : frontier)
+                {
+                    in_frontier.reset(v);
+                }
+            }
+            else
+            {
+                result.top_down_steps++;
+                // Whoever sets the next-level bit first adopts the node
+                for_each_range(frontier.size(), ranges, [&](size_t begin, size_t end, size_t range)
+                               {
+                    for (size_t i = begin; i < end; ++i)
+                    {
+                        int v = frontier[i];
+                        for (size_t e = offsets[v]; e < offsets[v + 1]; ++e)
+                        {
+                            int w = neighbors[e];
+                            if (!visited.test(w) && in_next.set(w))
+                            {
+                                level[w] = depth + 1;
+                                found[range].push_back(w);
+                            }
+                        }
+                    } });
+            }
+
+            // Ranges are in node (or frontier) order, so this keeps the order
+            frontier.clear();
+            for (size_t range = 0; range < ranges; ++range)
+            {
+                frontier.insert(frontier.end(), found[range].begin(), found[range].end());
+                found[range].clear();
+            }
+
+            for (int w : frontier)
+            {
+                visited.set(w);
+                in_next.reset(w);
+                unexplored -= offsets[w + 1] - offsets[w];
+            }
+            if (with_order && !frontier.empty())
+            {
+                by_level.insert(by_level.end(), frontier.begin(), frontier.end());
+                level_begin.push_back(by_level.size());
+            }
+        }
+
+        if (with_order)
+        {
+            order_by_levels(offsets, neighbors, level, by_level, level_begin, result.order);
+        }
+    }
+
+} // namespace graph
@@ -0,0 +1,39 @@
+#ifndef PARALLEL_BFS_H
+#define PARALLEL_BFS_H
+
+#include <cstddef>
+#include <vector>
+
+namespace graph
+{
+
+    struct BFSResult
+    {
+        std::vector<int> level; // Distance in edges from the source per node, -1 if unreachable
+        std::vector<int> order; // Visit order, only filled when requested
+        int top_down_steps = 0;
+        int bottom_up_steps = 0;
+    };
+
+    // Level-synchronous BFS over a CSR graph (Beamer's direction-optimizing
+    // BFS). Small frontiers expand top-down, each frontier node claiming its
+    // unvisited neighbors; once the frontier's edges outnumber what is left to
+    // visit, every unvisited node instead looks for a parent in the frontier
+    // bitmap and stops at the first one (bottom-up). Both steps run on the
+    // shared thread pool with atomic visited/frontier bitmaps.
+    //
+    // With with_order the visit order is exactly that of a sequential queue
+    // BFS. The traversal itself is unchanged; afterwards each level is ordered
+    // from the previous one: a node goes to the neighbor one level up with the
+    // smallest rank, then to the position of the edge in that neighbor's row.
+    //
+    // Used for single-source traversals (bfs_traversal). Closeness and
+    // harmonic centrality come out of the Brandes BFS in centrality.h, which
+    // parallelizes over sources instead, and components use a union-find;
+    // see the notes there.
+    void parallel_bfs(const std::vector<size_t> &offsets, const std::vector<int> &neighbors, int source,
+                      bool with_order, BFSResult &result);
+
+} // namespace graph
+
+#endif // PARALLEL_BFS_H
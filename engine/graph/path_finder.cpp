@@ -0,0 +1,194 @@
+#include "path_finder.h"
+#include <algorithm>
+#include <limits>
+
+using namespace std;
+
+namespace graph
+{
+
+    namespace
+    {
+        const double INFINITE_COST = numeric_limits<double>::infinity();
+    }
+
+    PathFinder::Search::Search(size_t node_count)
+        : distance(node_count, INFINITE_COST), previous(node_count, -1), settled(node_count, false)
+    {
+    }
+
+    void PathFinder::Search::reset()
+    {
+        for (int node : touched)
+        {
+            distance[node] = INFINITE_COST;
+            previous[node] = -1;
+            settled[node] = false;
+        }
+        touched.clear();
+        heap.clear();
+    }
+
+    void PathFinder::Search::reach(int node, double node_distance, int from)
+    {
+        if (node_distance < distance[node])
+        {
+            if (distance[node] == INFINITE_COST)
+            {
+                touched.push_back(node);
+            }
+            distance[node] = node_distance;
+            previous[node] = from;
+            heap.push(node_distance, node);
+        }
+    }
+
+    PathFinder::PathFinder(const vector<size_t> &row_begin, const vector<size_t> &row_end, const vector<int> &neighbors,
+                           const vector<double> &costs)
+        : m_row_begin(row_begin), m_row_end(row_end), m_neighbors(neighbors), m_costs(costs),
+          m_forward(row_begin.size()), m_backward(row_begin.size()), m_is_target(row_begin.size(), false)
+    {
+    }
+
+    bool PathFinder::settle_next(Search &search, int &node, double &distance)
+    {
+        while (!search.heap.empty())
+        {
+            node = search.heap.top_node();
+            distance = search.heap.top_key();
+            search.heap.pop();
+
+            // Skip entries superseded by a later, cheaper push
+            if (!search.settled[node] && distance == search.distance[node])
+            {
+                search.settled[node] = true;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    vector<int> PathFinder::trace_back(const Search &search, int node)
+    {
+        vector<int> path;
+        for (int current = node; current >= 0; current = search.previous[current])
+        {
+            path.push_back(current);
+        }
+        reverse(path.begin(), path.end());
+        return path;
+    }
+
+    bool PathFinder::find_path(int source, int target, vector<int> &path, double &cost)
+    {
+        path.clear();
+        cost = INFINITE_COST;
+
+        if (source == target)
+        {
+            path.push_back(source);
+            cost = 0.0;
+            return true;
+        }
+
+        m_forward.reset();
+        m_backward.reset();
+        m_forward.reach(source, 0.0, -1);
+        m_backward.reach(target, 0.0, -1);
+
+        int meeting_node = -1;
+        while (!m_forward.heap.empty() && !m_backward.heap.empty())
+        {
+            // No undiscovered path can beat the best one found so far
+            if (m_forward.heap.top_key() + m_backward.heap.top_key() >= cost)
+            {
+                break;
+            }
+
+            // Grow the smaller frontier
+            bool forward = m_forward.heap.size() <= m_backward.heap.size();
+            Search &search = forward ? m_forward : m_backward;
+            const Search &other = forward ? m_backward : m_forward;
+
+            int node;
+            double distance;
+            if (!settle_next(search, node, distance))
+            {
+                break;
+            }
+
+            for (size_t e = m_row_begin[node]; e < m_row_end[node]; ++e)
+            {
+                int neighbor = m_neighbors[e];
+                search.reach(neighbor, distance + m_costs[e], node);
+
+                double through = search.distance[neighbor] + other.distance[neighbor];
+                if (through < cost)
+                {
+                    cost = through;
+                    meeting_node = neighbor;
+                }
+            }
+        }
+
+        if (meeting_node < 0)
+        {
+            return false;
+        }
+
+        // Source to meeting node, then meeting node back to the target
+        path = trace_back(m_forward, meeting_node);
+        for (int current = m_backward.previous[meeting_node]; current >= 0; current = m_backward.previous[current])
+        {
+            path.push_back(current);
+        }
+        return true;
+    }
+
+    void PathFinder::find_paths(int source, const vector<int> &targets, vector<vector<int>> &paths,
+                                vector<double> &costs)
+    {
+        paths.assign(targets.size(), vector<int>());
+        costs.assign(targets.size(), INFINITE_COST);
+
+        m_forward.reset();
+        m_forward.reach(source, 0.0, -1);
+
+        // Targets still waiting to be settled (duplicates count once)
+        size_t remaining = 0;
+        for (int target : targets)
+        {
+            if (!m_is_target[target])
+            {
+                m_is_target[target] = true;
+                remaining++;
+            }
+        }
+
+        int node;
+        double distance;
+        while (remaining > 0 && settle_next(m_forward, node, distance))
+        {
+            if (m_is_target[node])
+            {
+                remaining--;
+            }
+
+            for (size_t e = m_row_begin[node]; e < m_row_end[node]; ++e)
+            {
+                m_forward.reach(m_neighbors[e], distance + m_costs[e], node);
+            }
+        }
+
+        for (size_t i = 0; i < targets.size(); ++i)
+        {
+            if (m_forward.settled[targets[i]])
+            {
+                paths[i] = trace_back(m_forward, targets[i]);
+                costs[i] = m_forward.distance[targets[i]];
+            }
+            m_is_target[targets[i]] = false;
+        }
+    }
+
+} // namespace graph
@@ -0,0 +1,65 @@
+#ifndef PATH_FINDER_H
+#define PATH_FINDER_H
+
+#include <cstddef>
+#include <vector>
+#include "quaternary_heap.h"
+
+namespace graph
+{
+
+    // Dijkstra with non-negative edge costs over an adjacency given as row
+    // ranges: the neighbors of u are neighbors[row_begin[u] .. row_end[u]), so
+    // both a packed CSR and rows with slack (live updates) can be searched. The
+    // scratch arrays are sized once and reset through a list of touched nodes,
+    // so a query only costs as much as the part of the graph it explores. Not
+    // thread-safe: use one PathFinder per thread.
+    class PathFinder
+    {
+    public:
+        PathFinder(const std::vector<size_t> &row_begin, const std::vector<size_t> &row_end,
+                   const std::vector<int> &neighbors, const std::vector<double> &costs);
+
+        // Cheapest path by bidirectional Dijkstra (the graph is undirected, so the
+        // backward search uses the same adjacency). Returns false if unreachable.
+        bool find_path(int source, int target, std::vector<int> &path, double &cost);
+
+        // Cheapest paths from one source to several targets with a single Dijkstra
+        // run that stops once every target is settled. Unreachable targets get an
+        // empty path and an infinite cost.
+        void find_paths(int source, const std::vector<int> &targets,
+                        std::vector<std::vector<int>> &paths, std::vector<double> &costs);
+
+    private:
+        // State of one Dijkstra search
+        struct Search
+        {
+            std::vector<double> distance;
+            std::vector<int> previous;
+            std::vector<bool> settled;
+            std::vector<int> touched;
+            QuaternaryHeap heap;
+
+            explicit Search(size_t node_count);
+            void reset();
+            void reach(int node, double node_distance, int from);
+        };
+
+        const std::vector<size_t> &m_row_begin;
+        const std::vector<size_t> &m_row_end;
+        const std::vector<int> &m_neighbors;
+        const std::vector<double> &m_costs;
+        Search m_forward;
+        Search m_backward;
+        std::vector<bool> m_is_target; // Scratch for find_paths
+
+        // Settle the next node of a search; false if only stale entries were left
+        bool settle_next(Search &search, int &node, double &distance);
+
+        // Nodes from the search root to node, following the previous links
+        static std::vector<int> trace_back(const Search &search, int node);
+    };
+
+} // namespace graph
+
+#endif // PATH_FINDER_H
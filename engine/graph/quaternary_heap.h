@@ -0,0 +1,90 @@
+#ifndef QUATERNARY_HEAP_H
+#define QUATERNARY_HEAP_H
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace graph
+{
+
+    // Min-heap of (key, node) pairs with four children per slot. Compared to a
+    // binary heap it is half as deep and the children of a slot share a cache
+    // line, which is what Dijkstra's many pushes and pops care about. There is
+    // no decrease-key: callers push again and skip stale entries on pop.
+    class QuaternaryHeap
+    {
+    public:
+        bool empty() const { return m_items.empty(); }
+        size_t size() const { return m_items.size(); }
+        void clear() { m_items.clear(); }
+
+        double top_key() const { return m_items.front().first; }
+        int top_node() const { return m_items.front().second; }
+
+        void push(double key, int node)
+        {
+            size_t slot = m_items.size();
+            m_items.emplace_back(key, node);
+
+            // Sift up
+            while (slot > 0)
+            {
+                size_t parent = (slot - 1) / 4;
+                if (m_items[parent].first <= key)
+                {
+                    break;
+                }
+                m_items[slot] = m_items[parent];
+                slot = parent;
+            }
+            m_items[slot] = std::make_pair(key, node);
+        }
+
+        void pop()
+        {
+            std::pair<double, int> last = m_items.back();
+            m_items.pop_back();
+            if (m_items.empty())
+            {
+                return;
+            }
+
+            // Sift the last item down from the root
+            size_t slot = 0;
+            size_t count = m_items.size();
+            while (true)
+            {
+                size_t first_child = slot * 4 + 1;
+                if (first_child >= count)
+                {
+                    break;
+                }
+
+                size_t best = first_child;
+                size_t last_child = first_child + 4 < count ? first_child + 4 : count;
+                for (size_t child = first_child + 1; child < last_child; ++child)
+                {
+                    if (m_items[child].first < m_items[best].first)
+                    {
+                        best = child;
+                    }
+                }
+
+                if (last.first <= m_items[best].first)
+                {
+                    break;
+                }
+                m_items[slot] = m_items[best];
+                slot = best;
+            }
+            m_items[slot] = last;
+        }
+
+    private:
+        std::vector<std::pair<double, int>> m_items;
+    };
+
+} // namespace graph
+
+#endif // QUATERNARY_HEAP_H
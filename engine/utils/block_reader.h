@@ -0,0 +1,157 @@
+#ifndef BLOCK_READER_H
+#define BLOCK_READER_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace utils
+{
+
+    // Reads a file in fixed-size blocks on a background thread with two
+    // buffers, so the next block is read from disk while the caller is still
+    // processing the current one. Memory use is two blocks regardless of file size.
+    class BlockReader
+    {
+    public:
+        explicit BlockReader(size_t block_size = 4 << 20)
+            : m_block_size(block_size)
+        {
+            for (int i = 0; i < 2; ++i)
+            {
+                m_buffers[i].resize(block_size);
+            }
+        }
+
+        ~BlockReader() { close(); }
+
+        BlockReader(const BlockReader &) = delete;
+        BlockReader &operator=(const BlockReader &) = delete;
+
+        bool open(const std::string &filename)
+        {
+            close();
+
+            m_file.open(filename, std::ios::binary);
+            if (!m_file.is_open())
+            {
+                return false;
+            }
+
+            m_stopping = false;
+            m_consumer_index = 0;
+            m_holding = false;
+            for (int i = 0; i < 2; ++i)
+            {
+                m_ready[i] = false;
+                m_sizes[i] = 0;
+            }
+
+            m_thread = std::thread([this]()
+                                   { read_loop(); });
+            return true;
+        }
+
+        // Hand out the next block and release the previous one; returns false at end of file
+        bool next(const char *&data, size_t &size)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+
+            if (m_holding)
+            {
+                m_ready[m_consumer_index] = false;
+                m_consumer_index ^= 1;
+                m_holding = false;
+                m_changed.notify_all();
+            }
+
+            m_changed.wait(lock, [this]()
+                           { return m_ready[m_consumer_index]; });
+
+            if (m_sizes[m_consumer_index] == 0)
+            {
+                return false;
+            }
+
+            m_holding = true;
+            data = m_buffers[m_consumer_index].data();
+            size = m_sizes[m_consumer_index];
+            return true;
+        }
+
+        void close()
+        {
+            if (m_thread.joinable())
+            {
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_stopping = true;
+                }
+                m_changed.notify_all();
+                m_thread.join();
+            }
+
+            if (m_file.is_open())
+            {
+                m_file.close();
+            }
+        }
+
+    private:
+        size_t m_block_size;
+        std::ifstream m_file;
+        std::thread m_thread;
+        std::mutex m_mutex;
+        std::condition_variable m_changed;
+
+        std::vector<char> m_buffers[2];
+        size_t m_sizes[2] = {0, 0};
+        bool m_ready[2] = {false, false}; // Filled and not yet released by the consumer
+        int m_consumer_index = 0;
+        bool m_holding = false;
+        bool m_stopping = false;
+
+        void read_loop()
+        {
+            int index = 0;
+
+            while (true)
+            {
+                {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    m_changed.wait(lock, [&]()
+                                   { return m_stopping || !m_ready[index]; });
+                    if (m_stopping)
+                    {
+                        return;
+                    }
+                }
+
+                // Only this thread touches a buffer that is not ready
+                m_file.read(m_buffers[index].data(), m_block_size);
+                size_t count = static_cast<size_t>(m_file.gcount());
+
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_sizes[index] = count;
+                    m_ready[index] = true;
+                }
+                m_changed.notify_all();
+
+                // An empty block marks the end of the file
+                if (count == 0)
+                {
+                    return;
+                }
+                index ^= 1;
+            }
+        }
+    };
+
+} // namespace utils
+
+#endif // BLOCK_READER_H
@@ -1,6 +1,7 @@
 #ifndef JSON_EXPORTER_H
 #define JSON_EXPORTER_H
 
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <map>
@@ -10,6 +11,23 @@
 namespace utils
 {
 
+    // Create the directory a file is going to be written to
+    inline void create_parent_directory(const std::string &filename)
+    {
+        size_t last_slash = filename.find_last_of("/\\");
+        if (last_slash != std::string::npos)
+        {
+            std::string dir = filename.substr(0, last_slash);
+// Create directory using system command (cross-platform)
+#ifdef _WIN32
+            std::string cmd = "mkdir \"" + dir + "\" 2> nul";
+#else
+            std::string cmd = "mkdir -p \"" + dir + "\"";
+#endif
+            system(cmd.c_str());
+        }
+    }
+
     class JSONExporter
     {
     public:
@@ -29,7 +47,7 @@ namespace utils
         }
 
         // Add a simple key-value pair (for integers)
-        void add_int(const std::string &key, int value)
+        void add_int(const std::string &key, long long value)
         {
             add_indent();
             m_json_data += "\"" + key + "\": " + std::to_string(value) + ",\n";
@@ -51,21 +69,25 @@ namespace utils
 
         // Add an array of integers
         void add_int_array(const std::string &key, const std::vector<int> &values)
+        {
+            add_int_range(key, values.begin(), values.end());
+        }
+
+        // Add an array of integers from any forward range (e.g. a compressed container)
+        template <typename Iterator>
+        void add_int_range(const std::string &key, Iterator first, Iterator last)
         {
             add_indent();
-            m_json_data += "\"" + key + "\": [\n";
+            m_json_data += "\"" + key + "\": [";
             m_indent_level++;
 
-            for (size_t i = 0; i < values.size(); ++i)
+            for (Iterator it = first; it != last; ++it)
             {
+                m_json_data += it == first ? "\n" : ",\n";
                 add_indent();
-                m_json_data += std::to_string(values[i]);
-                if (i < values.size() - 1)
-                {
-                    m_json_data += ",";
-                }
-                m_json_data += "\n";
+                m_json_data += std::to_string(*it);
             }
+            m_json_data += "\n";
 
             m_indent_level--;
             add_indent();
@@ -95,24 +117,25 @@ namespace utils
             m_json_data += "],\n";
         }
 
-        // Add a 2D grid (for mutation simulator)
-        void add_grid(const std::string &key, const std::vector<std::vector<int>> &grid)
+        // Add a 2D grid stored row-major in a flat array (for mutation simulator)
+        void add_grid(const std::string &key, const std::vector<uint8_t> &cells, size_t columns)
         {
             add_indent();
             m_json_data += "\"" + key + "\": [\n";
             m_indent_level++;
 
-            for (size_t i = 0; i < grid.size(); ++i)
+            size_t rows = columns == 0 ? 0 : cells.size() / columns;
+            for (size_t i = 0; i < rows; ++i)
             {
                 add_indent();
                 m_json_data += "[\n";
                 m_indent_level++;
 
-                for (size_t j = 0; j < grid[i].size(); ++j)
+                for (size_t j = 0; j < columns; ++j)
                 {
                     add_indent();
-                    m_json_data += std::to_string(grid[i][j]);
-                    if (j < grid[i].size() - 1)
+                    m_json_data += std::to_string(cells[i * columns + j]);
+                    if (j < columns - 1)
                     {
                         m_json_data += ",";
                     }
@@ -122,7 +145,7 @@ namespace utils
                 m_indent_level--;
                 add_indent();
                 m_json_data += "]";
-                if (i < grid.size() - 1)
+                if (i < rows - 1)
                 {
                     m_json_data += ",";
                 }
@@ -154,7 +177,7 @@ namespace utils
             {
                 add_indent();
                 // Check if the value is a number (no quotes)
-                bool is_numeric = true;
+                bool is_numeric = !value.empty();
                 for (char c : value)
                 {
                     if (!isdigit(c) && c != '.' && c != '-')
@@ -191,6 +214,33 @@ namespace utils
             m_json_data += "\n";
         }
 
+        // Start an object inside the current array; fill it with the add_* methods
+        void start_object()
+        {
+            add_indent();
+            m_json_data += "{\n";
+            m_indent_level++;
+        }
+
+        // End the current object
+        void end_object(bool is_last = false)
+        {
+            // Remove the trailing comma of the last member
+            if (m_json_data.size() > 2 && m_json_data.compare(m_json_data.size() - 2, 2, ",\n") == 0)
+            {
+                m_json_data.erase(m_json_data.size() - 2, 1);
+            }
+
+            m_indent_level--;
+            add_indent();
+            m_json_data += "}";
+            if (!is_last)
+            {
+                m_json_data += ",";
+            }
+            m_json_data += "\n";
+        }
+
         // End the current array
         void end_array()
         {
@@ -205,18 +255,7 @@ namespace utils
             try
             {
                 // Create directory if it doesn't exist
-                size_t last_slash = filename.find_last_of("/\\");
-                if (last_slash != std::string::npos)
-                {
-                    std::string dir = filename.substr(0, last_slash);
-// Create directory using system command (cross-platform)
-#ifdef _WIN32
-                    std::string cmd = "mkdir \"" + dir + "\" 2> nul";
-#else
-                    std::string cmd = "mkdir -p \"" + dir + "\"";
-#endif
-                    system(cmd.c_str());
-                }
+                create_parent_directory(filename);
 
                 // Remove the last comma and newline
                 if (m_json_data.size() > 2)
@@ -259,6 +298,116 @@ namespace utils
         }
     };
 
+    // Writes a flat JSON object straight to disk, for results too large to
+    // build in memory. Array values are written as they are produced.
+    class JSONStreamWriter
+    {
+    public:
+        JSONStreamWriter() = default;
+        ~JSONStreamWriter() { close(); }
+
+        bool open(const std::string &filename)
+        {
+            create_parent_directory(filename);
+            m_file.open(filename);
+            if (!m_file.is_open())
+            {
+                std::cerr << "Failed to open file: " << filename << std::endl;
+                return false;
+            }
+
+            m_file << "{";
+            m_first_field = true;
+            return true;
+        }
+
+        void add_string(const std::string &key, const std::string &value)
+        {
+            start_field(key);
+            m_file << "\"" << value << "\"";
+        }
+
+        void add_int(const std::string &key, long long value)
+        {
+            start_field(key);
+            m_file << value;
+        }
+
+        void add_double(const std::string &key, double value)
+        {
+            start_field(key);
+            m_file << std::to_string(value);
+        }
+
+        // Open an array of integers; fill it with add_array_value
+        void start_array(const std::string &key)
+        {
+            start_field(key);
+            m_file << "[";
+            m_first_value = true;
+        }
+
+        void add_array_value(long long value)
+        {
+            m_file << (m_first_value ? "\n    " : ",\n    ") << value;
+            m_first_value = false;
+        }
+
+        // Add a flat object to the current array (numeric values are written unquoted)
+        void add_array_object(const std::map<std::string, std::string> &obj)
+        {
+            m_file << (m_first_value ? "\n    {" : ",\n    {");
+            m_first_value = false;
+
+            bool first_member = true;
+            for (const auto &[key, value] : obj)
+            {
+                bool is_numeric = !value.empty() && value.find_first_not_of("0123456789.-") == std::string::npos;
+                m_file << (first_member ? "" : ", ") << "\"" << key << "\": ";
+                if (is_numeric)
+                {
+                    m_file << value;
+                }
+                else
+                {
+                    m_file << "\"" << value << "\"";
+                }
+                first_member = false;
+            }
+            m_file << "}";
+        }
+
+        void end_array()
+        {
+            m_file << (m_first_value ? "]" : "\n  ]");
+        }
+
+        // Close the object and the file; returns false if any write failed
+        bool close()
+        {
+            if (!m_file.is_open())
+            {
+                return true;
+            }
+
+            m_file << "\n}\n";
+            bool ok = static_cast<bool>(m_file);
+            m_file.close();
+            return ok;
+        }
+
+    private:
+        std::ofstream m_file;
+        bool m_first_field = true;
+        bool m_first_value = true;
+
+        void start_field(const std::string &key)
+        {
+            m_file << (m_first_field ? "\n  " : ",\n  ") << "\"" << key << "\": ";
+            m_first_field = false;
+        }
+    };
+
 } // namespace utils
 
 #endif // JSON_EXPORTER_H
@@ -0,0 +1,159 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <string>
+#include <cstddef>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace utils
+{
+
+    // Read-only memory mapping of a whole file, so large inputs can be scanned
+    // in place instead of being copied through stream buffers.
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+        ~MappedFile() { close(); }
+
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        // Map the file; an empty file opens successfully with size() == 0
+        bool open(const std::string &filename)
+        {
+            close();
+
+#ifdef _WIN32
+            m_file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                 OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+            if (m_file == INVALID_HANDLE_VALUE)
+            {
+                return false;
+            }
+
+            LARGE_INTEGER file_size;
+            if (!GetFileSizeEx(m_file, &file_size))
+            {
+                close();
+                return false;
+            }
+            m_size = static_cast<size_t>(file_size.QuadPart);
+
+            if (m_size > 0)
+            {
+                m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                if (m_mapping == nullptr)
+                {
+                    close();
+                    return false;
+                }
+
+                m_data = static_cast<const char *>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+                if (m_data == nullptr)
+                {
+                    close();
+                    return false;
+                }
+            }
+#else
+            m_fd = ::open(filename.c_str(), O_RDONLY);
+            if (m_fd < 0)
+            {
+                return false;
+            }
+
+            struct stat file_stat;
+            if (fstat(m_fd, &file_stat) != 0)
+            {
+                close();
+                return false;
+            }
+            m_size = static_cast<size_t>(file_stat.st_size);
+
+            if (m_size > 0)
+            {
+                void *address = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_fd, 0);
+                if (address == MAP_FAILED)
+                {
+                    close();
+                    return false;
+                }
+
+                // The loaders read front to back, so let the kernel read ahead aggressively
+                madvise(address, m_size, MADV_SEQUENTIAL);
+                m_data = static_cast<const char *>(address);
+            }
+#endif
+
+            m_open = true;
+            return true;
+        }
+
+        void close()
+        {
+#ifdef _WIN32
+            if (m_data != nullptr)
+            {
+                UnmapViewOfFile(m_data);
+            }
+            if (m_mapping != nullptr)
+            {
+                CloseHandle(m_mapping);
+            }
+            if (m_file != INVALID_HANDLE_VALUE)
+            {
+                CloseHandle(m_file);
+            }
+            m_mapping = nullptr;
+            m_file = INVALID_HANDLE_VALUE;
+#else
+            if (m_data != nullptr)
+            {
+                munmap(const_cast<char *>(m_data), m_size);
+            }
+            if (m_fd >= 0)
+            {
+                ::close(m_fd);
+            }
+            m_fd = -1;
+#endif
+            m_data = nullptr;
+            m_size = 0;
+            m_open = false;
+        }
+
+        bool is_open() const { return m_open; }
+        const char *data() const { return m_data; }
+        size_t size() const { return m_size; }
+
+    private:
+        const char *m_data = nullptr;
+        size_t m_size = 0;
+        bool m_open = false;
+
+#ifdef _WIN32
+        HANDLE m_file = INVALID_HANDLE_VALUE;
+        HANDLE m_mapping = nullptr;
+#else
+        int m_fd = -1;
+#endif
+    };
+
+} // namespace utils
+
+#endif // MAPPED_FILE_H
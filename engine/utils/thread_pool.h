@@ -0,0 +1,166 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace utils
+{
+
+    // Fixed set of worker threads running indexed parallel loops. The calling
+    // thread takes part in the loop, so a pool of size 1 has no extra threads.
+    class ThreadPool
+    {
+    public:
+        // threads == 0 uses one thread per hardware core
+        explicit ThreadPool(size_t threads = 0)
+        {
+            if (threads == 0)
+            {
+                threads = std::thread::hardware_concurrency();
+            }
+            if (threads == 0)
+            {
+                threads = 1;
+            }
+
+            for (size_t i = 1; i < threads; ++i)
+            {
+                m_workers.emplace_back([this]()
+                                       { worker_loop(); });
+            }
+        }
+
+        ~ThreadPool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stopping = true;
+            }
+            m_wake.notify_all();
+
+            for (std::thread &worker : m_workers)
+            {
+                worker.join();
+            }
+        }
+
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+        // Number of threads taking part in a loop (workers plus the caller)
+        size_t size() const { return m_workers.size() + 1; }
+
+        // Run task(i) for every i in [0, count) and wait for all of them.
+        // Calls made from inside a task run serially on the calling thread.
+        void parallel_for(size_t count, const std::function<void(size_t)> &task)
+        {
+            if (count == 0)
+            {
+                return;
+            }
+
+            if (m_workers.empty() || count == 1 || in_worker())
+            {
+                for (size_t i = 0; i < count; ++i)
+                {
+                    task(i);
+                }
+                return;
+            }
+
+            std::lock_guard<std::mutex> job_lock(m_job_mutex);
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_task = &task;
+                m_count = count;
+                m_next.store(0);
+                m_active = m_workers.size();
+                m_generation++;
+            }
+            m_wake.notify_all();
+
+            run_tasks();
+
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_done.wait(lock, [this]()
+                        { return m_active == 0; });
+            m_task = nullptr;
+        }
+
+        // Process-wide pool shared by the engine modules
+        static ThreadPool &shared()
+        {
+            static ThreadPool pool;
+            return pool;
+        }
+
+    private:
+        std::vector<std::thread> m_workers;
+        std::mutex m_job_mutex; // Serializes parallel_for calls from different threads
+        std::mutex m_mutex;
+        std::condition_variable m_wake;
+        std::condition_variable m_done;
+
+        const std::function<void(size_t)> *m_task = nullptr;
+        size_t m_count = 0;
+        std::atomic<size_t> m_next{0};
+        size_t m_active = 0;
+        size_t m_generation = 0;
+        bool m_stopping = false;
+
+        static bool &in_worker()
+        {
+            static thread_local bool flag = false;
+            return flag;
+        }
+
+        void run_tasks()
+        {
+            bool was_in_worker = in_worker();
+            in_worker() = true;
+
+            for (size_t i = m_next.fetch_add(1); i < m_count; i = m_next.fetch_add(1))
+            {
+                (*m_task)(i);
+            }
+
+            in_worker() = was_in_worker;
+        }
+
+        void worker_loop()
+        {
+            size_t seen_generation = 0;
+
+            while (true)
+            {
+                {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    m_wake.wait(lock, [&]()
+                                { return m_stopping || m_generation != seen_generation; });
+                    if (m_stopping)
+                    {
+                        return;
+                    }
+                    seen_generation = m_generation;
+                }
+
+                run_tasks();
+
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_active--;
+                }
+                m_done.notify_one();
+            }
+        }
+    };
+
+} // namespace utils
+
+#endif // THREAD_POOL_H
@@ -3,6 +3,7 @@
 #include <vector>
 #include <fstream>
 #include <memory>
+#include <sstream>
 
 using namespace std;
 
@@ -40,6 +41,14 @@ void print_menu()
     cout << "2. Gene/Protein Interaction Graph Analyzer" << endl;
     cout << "3. Evolution & Mutation Spread Simulator" << endl;
     cout << "4. Protein Structural Data Parser" << endl;
+    cout << "5. DNA Search Benchmark (naive, KMP, parallel KMP, SIMD, FM-index)" << endl;
+    cout << "6. DNA Multi-Pattern Screening (Aho-Corasick)" << endl;
+    cout << "7. DNA Approximate Search (mismatches / edits)" << endl;
+    cout << "8. DNA Degenerate Primer Search (IUPAC, both strands)" << endl;
+    cout << "9. DNA Streaming Search (FASTA larger than memory)" << endl;
+    cout << "10. Interaction Path Queries (most confident paths)" << endl;
+    cout << "11. Interaction Network Update (add/remove interactions)" << endl;
+    cout << "12. Interaction Snapshot (save binary graph for fast reload)" << endl;
     cout << "0. Exit" << endl;
     cout << "Enter your choice: ";
 }
@@ -68,7 +77,12 @@ int main()
             cout << "Enter pattern to search: ";
             cin >> pattern;
 
+            string count_only;
+            cout << "Count matches only, without storing positions? (y/n): ";
+            cin >> count_only;
+
             dna::DNASearchEngine search_engine;
+            search_engine.set_count_only(count_only == "y" || count_only == "Y");
             if (search_engine.load_fasta(filename))
             {
                 search_engine.search_pattern(pattern, "KMP");
@@ -87,7 +101,12 @@ int main()
             cout << "Enter start node for traversal: ";
             cin >> start_node;
 
+            size_t pivots = 0;
+            cout << "Enter betweenness sample size (0 for exact): ";
+            cin >> pivots;
+
             graph::GraphAnalyzer graph_analyzer;
+            graph_analyzer.set_centrality_pivots(pivots);
             if (graph_analyzer.load_interactions(filename))
             {
                 graph_analyzer.analyze(start_node);
@@ -99,25 +118,60 @@ int main()
         }
         case 3:
         {
-            int grid_size, steps;
-            double mutation_prob, resistance_prob;
+            string checkpoint, checkpoint_output;
+            int steps;
+
+            cout << "Enter checkpoint to resume from (- to start a new run): ";
+            cin >> checkpoint;
+
+            evolution::MutationSimulator simulator;
+            if (checkpoint == "-")
+            {
+                int grid_size;
+                double mutation_prob, resistance_prob;
+                uint64_t seed;
 
-            cout << "Enter grid size: ";
-            cin >> grid_size;
+                cout << "Enter grid size: ";
+                cin >> grid_size;
+
+                cout << "Enter mutation probability (0.0-1.0): ";
+                cin >> mutation_prob;
+
+                cout << "Enter resistance probability (0.0-1.0): ";
+                cin >> resistance_prob;
+
+                cout << "Enter random seed (0 for time-based): ";
+                cin >> seed;
+
+                if (seed == 0)
+                {
+                    simulator = evolution::MutationSimulator(grid_size, mutation_prob, resistance_prob);
+                }
+                else
+                {
+                    simulator = evolution::MutationSimulator(grid_size, mutation_prob, resistance_prob, seed);
+                }
+            }
+            else if (!simulator.load_checkpoint(checkpoint))
+            {
+                break;
+            }
 
             cout << "Enter number of simulation steps: ";
             cin >> steps;
 
-            cout << "Enter mutation probability (0.0-1.0): ";
-            cin >> mutation_prob;
-
-            cout << "Enter resistance probability (0.0-1.0): ";
-            cin >> resistance_prob;
+            cout << "Enter checkpoint output path (- to skip): ";
+            cin >> checkpoint_output;
 
-            evolution::MutationSimulator simulator(grid_size, mutation_prob, resistance_prob);
             simulator.run_simulation(steps);
             simulator.export_results("output/mutation_simulation_results.json");
             cout << "Results exported to output/mutation_simulation_results.json" << endl;
+
+            if (checkpoint_output != "-" && simulator.save_checkpoint(checkpoint_output))
+            {
+                cout << "Checkpoint saved to " << checkpoint_output << " (seed " << simulator.seed()
+                     << ", step " << simulator.step() << ")" << endl;
+            }
             break;
         }
         case 4:
@@ -136,6 +190,256 @@ int main()
 
             break;
         }
+        case 5:
+        {
+            string filename, pattern_list;
+
+            cout << "Enter FASTA file path: ";
+            cin >> filename;
+
+            cout << "Enter comma-separated patterns to benchmark: ";
+            cin >> pattern_list;
+
+            vector<string> patterns;
+            stringstream pattern_stream(pattern_list);
+            string pattern;
+            while (getline(pattern_stream, pattern, ','))
+            {
+                if (!pattern.empty())
+                {
+                    patterns.push_back(pattern);
+                }
+            }
+
+            string index_file;
+            cout << "Enter FM-index file (reused if it exists, saved otherwise; - to skip): ";
+            cin >> index_file;
+
+            dna::DNASearchEngine search_engine;
+            if (search_engine.load_fasta(filename))
+            {
+                // An index that fails to load (other sequence, corrupt file) is rebuilt and overwritten
+                bool index_loaded = index_file != "-" && fs::exists(index_file) && search_engine.load_index(index_file);
+                if (index_loaded)
+                {
+                    cout << "Reusing FM-index from " << index_file << endl;
+                }
+
+                search_engine.benchmark(patterns, "output/dna_benchmark_results.json");
+                cout << "Results exported to output/dna_benchmark_results.json" << endl;
+
+                if (index_file != "-" && !index_loaded && search_engine.save_index(index_file))
+                {
+                    cout << "FM-index saved to " << index_file << endl;
+                }
+            }
+            break;
+        }
+        case 6:
+        {
+            string filename, pattern_file;
+
+            cout << "Enter FASTA file path: ";
+            cin >> filename;
+
+            cout << "Enter pattern file path (FASTA of probes or one pattern per line): ";
+            cin >> pattern_file;
+
+            dna::DNASearchEngine search_engine;
+            if (search_engine.load_fasta(filename) && search_engine.search_pattern_file(pattern_file))
+            {
+                search_engine.export_results("output/dna_search_results.json");
+                cout << "Results exported to output/dna_search_results.json" << endl;
+            }
+            break;
+        }
+        case 7:
+        {
+            string filename, pattern, mode;
+            int max_errors;
+
+            cout << "Enter FASTA file path: ";
+            cin >> filename;
+
+            cout << "Enter pattern to search (up to 64 bases): ";
+            cin >> pattern;
+
+            cout << "Enter maximum number of errors: ";
+            cin >> max_errors;
+
+            cout << "Enter error model (hamming/edit): ";
+            cin >> mode;
+
+            dna::DNASearchEngine search_engine;
+            if (search_engine.load_fasta(filename))
+            {
+                search_engine.search_approximate(pattern, max_errors, mode);
+                search_engine.export_results("output/dna_search_results.json");
+                cout << "Results exported to output/dna_search_results.json" << endl;
+            }
+            break;
+        }
+        case 8:
+        {
+            string filename, pattern;
+
+            cout << "Enter FASTA file path: ";
+            cin >> filename;
+
+            cout << "Enter IUPAC pattern to search (up to 64 bases): ";
+            cin >> pattern;
+
+            dna::DNASearchEngine search_engine;
+            if (search_engine.load_fasta(filename))
+            {
+                search_engine.search_degenerate(pattern);
+                search_engine.export_results("output/dna_search_results.json");
+                cout << "Results exported to output/dna_search_results.json" << endl;
+            }
+            break;
+        }
+        case 9:
+        {
+            string filename, pattern;
+
+            cout << "Enter FASTA file path: ";
+            cin >> filename;
+
+            cout << "Enter pattern to search: ";
+            cin >> pattern;
+
+            dna::DNASearchEngine search_engine;
+            if (search_engine.stream_search(filename, pattern, "output/dna_search_results.json"))
+            {
+                cout << "Results exported to output/dna_search_results.json" << endl;
+            }
+            break;
+        }
+        case 10:
+        {
+            string filename, query_list;
+
+            cout << "Enter interaction CSV file path: ";
+            cin >> filename;
+
+            cout << "Enter comma-separated source:target pairs: ";
+            cin >> query_list;
+
+            vector<pair<string, string>> queries;
+            stringstream query_stream(query_list);
+            string query;
+            while (getline(query_stream, query, ','))
+            {
+                size_t separator = query.find(':');
+                if (separator != string::npos)
+                {
+                    queries.emplace_back(query.substr(0, separator), query.substr(separator + 1));
+                }
+            }
+
+            graph::GraphAnalyzer graph_analyzer;
+            if (graph_analyzer.load_interactions(filename))
+            {
+                graph_analyzer.find_paths(queries);
+                graph_analyzer.export_results("output/graph_analysis_results.json");
+                cout << "Results exported to output/graph_analysis_results.json" << endl;
+            }
+            break;
+        }
+        case 11:
+        {
+            string filename, add_list, remove_list, start_node;
+
+            cout << "Enter interaction CSV file path: ";
+            cin >> filename;
+
+            cout << "Enter comma-separated source:target[:weight] interactions to add (- for none): ";
+            cin >> add_list;
+
+            cout << "Enter comma-separated source:target interactions to remove (- for none): ";
+            cin >> remove_list;
+
+            cout << "Enter start node for traversal: ";
+            cin >> start_node;
+
+            vector<graph::Interaction> additions;
+            stringstream add_stream(add_list == "-" ? "" : add_list);
+            string item;
+            while (getline(add_stream, item, ','))
+            {
+                stringstream item_stream(item);
+                graph::Interaction interaction;
+                string weight;
+                if (getline(item_stream, interaction.source, ':') && getline(item_stream, interaction.target, ':'))
+                {
+                    if (getline(item_stream, weight, ':'))
+                    {
+                        try
+                        {
+                            interaction.weight = stod(weight);
+                        }
+                        catch (const exception &e)
+                        {
+                            cerr << "Warning: Invalid weight '" << weight << "', using 1.0" << endl;
+                        }
+                    }
+                    additions.push_back(interaction);
+                }
+            }
+
+            vector<pair<string, string>> removals;
+            stringstream remove_stream(remove_list == "-" ? "" : remove_list);
+            while (getline(remove_stream, item, ','))
+            {
+                size_t separator = item.find(':');
+                if (separator != string::npos)
+                {
+                    removals.emplace_back(item.substr(0, separator), item.substr(separator + 1));
+                }
+            }
+
+            graph::GraphAnalyzer graph_analyzer;
+            if (graph_analyzer.load_interactions(filename))
+            {
+                size_t added = graph_analyzer.add_interactions(additions);
+                size_t removed = graph_analyzer.remove_interactions(removals);
+                cout << "Added " << added << " and removed " << removed << " interactions" << endl;
+
+                graph_analyzer.analyze(start_node);
+                graph_analyzer.export_results("output/graph_analysis_results.json");
+                cout << "Results exported to output/graph_analysis_results.json" << endl;
+            }
+            break;
+        }
+        case 12:
+        {
+            string filename, snapshot_filename, start_node;
+
+            cout << "Enter interaction CSV file path: ";
+            cin >> filename;
+
+            cout << "Enter snapshot output path: ";
+            cin >> snapshot_filename;
+
+            cout << "Enter start node for traversal (- to skip analysis): ";
+            cin >> start_node;
+
+            // Snapshots hold the cached scores, so analyze first to store them
+            graph::GraphAnalyzer graph_analyzer;
+            if (graph_analyzer.load_interactions(filename))
+            {
+                if (start_node != "-")
+                {
+                    graph_analyzer.analyze(start_node);
+                }
+                if (graph_analyzer.save_snapshot(snapshot_filename))
+                {
+                    cout << "Snapshot saved to " << snapshot_filename
+                         << " (it can be given instead of a CSV file to the graph options)" << endl;
+                }
+            }
+            break;
+        }
         case 0:
             cout << "Exiting program. Goodbye!" << endl;
             break;